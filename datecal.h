@@ -9,6 +9,8 @@
 #include <sys/time.h>
 #include <assert.h>
 
+#include "dateprof.h"
+
 //! Modulo function, works with negative numbers
 int _mod(int a, int b)
 {
@@ -37,6 +39,40 @@ long long _divl(long long a, long long b)
     else return a / b - 1;
 }
 
+//! Number of days between 0000-01-01 and 1970-01-01
+#define D_DAYS_BEFORE_UNIX_EPOCH 719528LL
+
+//! Number of days between 1970-01-01 and a date of the proleptic Gregorian calendar (like datelib::days_from_civil)
+long long _days_from_civil(int year, int month, int day)
+{
+    long long y = (long long)year - (month <= 2);
+    long long era = _divl(y, 400);
+    long long year_of_era = y - era * 400;
+    long long day_of_era_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_era_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+//! Date of the proleptic Gregorian calendar a number of days after 1970-01-01 (like datelib::civil_from_days)
+void _civil_from_days(long long days, int* year, int* month, int* day)
+{
+    days += 719468;
+    long long era = _divl(days, 146097);
+    long long day_of_era = days - era * 146097;
+    long long year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    long long day_of_era_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    long long m = (5 * day_of_era_year + 2) / 153;
+    *month = (int)(m < 10 ? m + 3 : m - 9);
+    *year = (int)(year_of_era + era * 400 + (*month <= 2));
+    *day = (int)(day_of_era_year - (153 * m + 2) / 5 + 1);
+}
+
+//! Weekday (0..6, where 0 is Monday) of a Gregorian date, computed from the date alone
+int _weekday_of(int year, int month, int day)
+{
+    return (int)_modl(_days_from_civil(year, month, day) + 3, 7); // 1970-01-01 was Thursday
+}
+
 //! Date/time struct
 typedef struct
 {
@@ -79,6 +115,34 @@ const char* D_AMPM_SMALL[] = {"a.m.", "p.m."};
 const char* D_ADBC[] = {"CE", "BCE"};
 const char* D_PLUSMINUS[] = {"+", "-"};
 
+//! Weekday masks (bit 0 is Monday)
+#define D_EVERY_DAY 0x7F
+#define D_WORKDAYS 0x1F
+#define D_WEEKEND 0x60
+
+//! Rules of daylight saving time
+typedef enum
+{
+    D_DST_NONE,     //!< No daylight saving time
+    D_DST_EU,       //!< European Union: from the last Sunday of March to the last Sunday of October, at 01:00 UTC
+    D_DST_US,       //!< United States: from the second Sunday of March to the first Sunday of November, at 02:00 local time
+} dst_rule_t;
+
+//! Time zone with daylight saving time rules
+typedef struct
+{
+    int std_offset;         //!< Standard time offset in minutes to the east
+    dst_rule_t dst_rule;    //!< Daylight saving time (one hour ahead of standard time) rule
+    //! If not NULL, used instead of the fields above to get the offset (in minutes to the east) at an instant
+    int (*offset_at)(long long usec, void* arg);
+    void* arg;              //!< Argument passed to offset_at
+} time_zone_t;
+
+//! Europe/Warsaw, Europe/Berlin, Europe/Paris, ...
+#define D_ZONE_CENTRAL_EUROPE {60, D_DST_EU, NULL, NULL}
+//! America/New_York
+#define D_ZONE_US_EASTERN {-300, D_DST_US, NULL, NULL}
+
 //! \brief Current time in process' time zone
 //! \returns Current time
 date_t get_current_time();
@@ -144,6 +208,18 @@ long long usec_difference(date_t sooner, date_t later);
 timediff_t difference(date_t sooner, date_t later);
 //! Get date_t difference after a date
 date_t date_add(date_t date, timediff_t difference);
+//! Time zone offset (in minutes to the east) at an instant
+int zone_offset_at(const time_zone_t* zone, long long usec);
+/*! \brief Next instant after `after` which is at a local time of day in a time zone
+    \details Local times skipped by a change to daylight saving time are moved forward by the
+    length of the change, and local times which occur twice map to the later instant.
+    \param zone time zone
+    \param after instant after which to look
+    \param minute_of_day local time of day in minutes (0..1439)
+    \param weekdays weekdays to consider (bit 0 is Monday, see D_EVERY_DAY etc.)
+    \returns The instant, or `after` if weekdays is empty (no such instant exists)
+*/
+long long zone_next_local_time(const time_zone_t* zone, long long after, int minute_of_day, int weekdays);
 
 date_t get_current_time()
 {
@@ -154,6 +230,7 @@ date_t get_current_time()
     if (tz.tz_minuteswest == 0)
     {
         // Another failsafe method of checking the timezone
+        D_PROF_HIT(D_PROF_CURRENT_TIME_FALLBACK);
         time_t t = time(NULL);
         struct tm *local = localtime(&t);
         tz.tz_minuteswest = (int)-local->tm_gmtoff/60;
@@ -177,17 +254,20 @@ date_t make_date(int year, int month, int day, int hour, int minute, int second,
 
 void fix_date(date_t *date)
 {
+    D_PROF_HIT(D_PROF_FIX_DATE);
     if (date->hour == 24) date->hour = 0;
     convert_to_timezone(date, date->tz_offset);
 }
 
 time_t date_to_time(date_t date)
 {
+    D_PROF_BEGIN(D_PROF_DATE_TO_TIME);
     time_t time = date.second + 60 * (date.minute - date.tz_offset) + 3600 * date.hour;
     int days_since_epoch = date.day - unix_epoch.day;
     
     while (date.month > unix_epoch.month)
     {
+        D_PROF_HIT(D_PROF_DATE_TO_TIME_MONTH_STEP);
         date.month--;
         days_since_epoch += month_lengths[is_leap_year(date.year)][date.month - 1];
     }
@@ -196,11 +276,13 @@ time_t date_to_time(date_t date)
     
     time += days_since_epoch * 86400;
     
+    D_PROF_END(D_PROF_DATE_TO_TIME);
     return time;
 }
 
 date_t time_to_date(time_t time)
 {
+    D_PROF_BEGIN(D_PROF_TIME_TO_DATE);
     date_t date = {0};
     int days_since_epoch = _div(time, 86400);
     int time_of_day = _mod(time, 86400);
@@ -216,6 +298,7 @@ date_t time_to_date(time_t time)
     {
         while (days_since_epoch >= year_length(date.year))
         {
+            D_PROF_HIT(D_PROF_TIME_TO_DATE_YEAR_STEP);
             days_since_epoch -= year_length(date.year);
             date.year++;
         }
@@ -224,6 +307,7 @@ date_t time_to_date(time_t time)
     {
         while (days_since_epoch <= 0)
         {
+            D_PROF_HIT(D_PROF_TIME_TO_DATE_YEAR_STEP);
             date.year--;
             days_since_epoch += year_length(date.year);
         }
@@ -232,6 +316,7 @@ date_t time_to_date(time_t time)
     date.month = unix_epoch.month;
     while (days_since_epoch >= month_lengths[is_leap_year(date.year)][date.month - 1])
     {
+        D_PROF_HIT(D_PROF_TIME_TO_DATE_MONTH_STEP);
         days_since_epoch -= month_lengths[is_leap_year(date.year)][date.month - 1];
         date.month++;
     }
@@ -239,6 +324,7 @@ date_t time_to_date(time_t time)
     date.day = unix_epoch.day + days_since_epoch;
     date.tz_offset = 0;
     
+    D_PROF_END(D_PROF_TIME_TO_DATE);
     return date;
 }
 
@@ -278,6 +364,8 @@ int day_of_year(date_t date)
 
 int iso_week_number(date_t date)
 {
+    D_PROF_BEGIN(D_PROF_ISO_WEEK_NUMBER);
+    int week;
     date_t first_of_year = date;
     first_of_year.day = 1;
     first_of_year.month = 1;
@@ -287,12 +375,15 @@ int iso_week_number(date_t date)
     
     if (date_compare(first_of_year, date) == 1)
     {
-        return ((is_leap_year(date.year - 1)) ? 53 : 52);
+        week = ((is_leap_year(date.year - 1)) ? 53 : 52);
     }
     else
     {
-        return ((day_of_year(date) - first_of_year.day)/7 + 1);
+        week = ((day_of_year(date) - first_of_year.day)/7 + 1);
     }
+    
+    D_PROF_END(D_PROF_ISO_WEEK_NUMBER);
+    return week;
 }
 
 int iso_week_numbering_year(date_t date)
@@ -318,24 +409,22 @@ int century(int year)
 
 long long date_to_usec_since_zero(date_t date)
 {
-    long long time = ((date.hour * 60 + date.minute - date.tz_offset) * 60 + date.second) * 1000000L + date.usecond;
-    long long days_since_zero = date.day - 1;
-    
-    while (date.month > 1)
-    {
-        date.month--;
-        days_since_zero += month_lengths[is_leap_year(date.year)][date.month - 1];
-    }
-    
-    days_since_zero += date.year * 365 + leap_years_before(date.year + 1);
+    D_PROF_BEGIN(D_PROF_DATE_TO_USEC);
+    long long time = (((long long)date.hour * 60 + date.minute - date.tz_offset) * 60 + date.second) * 1000000L + date.usecond;
+    // Months out of 1..12 carry into the year, days out of the month are simply added
+    int year = date.year + _div(date.month - 1, 12);
+    int month = _mod(date.month - 1, 12) + 1;
+    long long days_since_zero = _days_from_civil(year, month, 1) + D_DAYS_BEFORE_UNIX_EPOCH + date.day - 1;
     
     time += days_since_zero * 86400000000L;
     
+    D_PROF_END(D_PROF_DATE_TO_USEC);
     return time;
 }
 
 date_t usec_since_zero_to_date(long long usec, int tz_offset)
 {
+    D_PROF_BEGIN(D_PROF_USEC_TO_DATE);
     date_t date = {0};
     
     usec += tz_offset * 60000000L;
@@ -351,29 +440,9 @@ date_t usec_since_zero_to_date(long long usec, int tz_offset)
     date.minute = (time_of_day / 60000000) % 60;
     date.hour = time_of_day / 3600000000;
     
-    static const int CYCLE_1 = 365;
-    static const int CYCLE_4 = (CYCLE_1   *  4 + 1);
-    static const int CYCLE_100 = (CYCLE_4   * 25 - 1);
-    static const int CYCLE_400 = (CYCLE_100 *  4 + 1);
-    
-    date.year += 400 * _divl(days_since_zero, CYCLE_400);
-    days_since_zero = _modl(days_since_zero, CYCLE_400);
-    date.year += 100 * _divl(days_since_zero, CYCLE_100);
-    days_since_zero = _modl(days_since_zero, CYCLE_100);
-    date.year += 4 * _divl(days_since_zero, CYCLE_4);
-    days_since_zero = _modl(days_since_zero, CYCLE_4);
-    date.year += 1 * _divl(days_since_zero, CYCLE_1);
-    days_since_zero = _modl(days_since_zero, CYCLE_1);
-    
-    date.month = 1;
-    while (days_since_zero >= month_lengths[is_leap_year(date.year)][date.month - 1])
-    {
-        days_since_zero -= month_lengths[is_leap_year(date.year)][date.month - 1];
-        date.month++;
-    }
-    
-    date.day = days_since_zero + (date.year < 0 ? 0 : 1);
+    _civil_from_days(days_since_zero - D_DAYS_BEFORE_UNIX_EPOCH, &date.year, &date.month, &date.day);
     
+    D_PROF_END(D_PROF_USEC_TO_DATE);
     return date;
 }
 
@@ -464,7 +533,76 @@ date_t date_add(date_t date, timediff_t difference)
 char* d_to_s(date_t d)
 {
     unsigned len = 35 + strlen(D_WEEKDAY_ABBRV[d.weekday]) + (d.year < 0 ? 1 : 0);
-    char* string = malloc(sizeof(char) * len);
+    char* string = (char*)malloc(sizeof(char) * len);
     snprintf(string, sizeof(char) * len, "%s, %04d-%02d-%02d %02d:%02d:%02d.%06d%c%02d:%02d", D_WEEKDAY_ABBRV[d.weekday], d.year, d.month, d.day, d.hour, d.minute, d.second, d.usecond, (d.tz_offset >= 0 ? '+' : '-'), abs(d.tz_offset) / 60, abs(d.tz_offset) % 60);
     return string;
 }
+
+//! Day of the month of the n-th (or last, for n = -1) Sunday of a month
+int _nth_sunday(int year, int month, int n)
+{
+    if (n < 0)
+    {
+        int last = month_lengths[is_leap_year(year)][month - 1];
+        return last - (_weekday_of(year, month, last) + 1) % 7;
+    }
+    return 1 + (6 - _weekday_of(year, month, 1)) + 7 * (n - 1);
+}
+
+//! Instant of a local time of day (in minutes) in a time zone, on a day counted from 0000-01-01
+long long _zone_local_time(const time_zone_t* zone, long long day, int minute_of_day)
+{
+    static const long long USEC_IN_DAY = 86400000000L;
+    static const long long USEC_IN_MINUTE = 60000000L;
+
+    // Local time as if it was UTC, then corrected by the offset in effect at that instant
+    long long wall = day * USEC_IN_DAY + minute_of_day * USEC_IN_MINUTE;
+    int offset = zone_offset_at(zone, wall - zone->std_offset * USEC_IN_MINUTE);
+    int actual = zone_offset_at(zone, wall - offset * USEC_IN_MINUTE);
+    return wall - actual * USEC_IN_MINUTE;
+}
+
+int zone_offset_at(const time_zone_t* zone, long long usec)
+{
+    static const long long USEC_IN_DAY = 86400000000L;
+    static const long long USEC_IN_MINUTE = 60000000L;
+
+    if (zone->offset_at != NULL) return zone->offset_at(usec, zone->arg);
+
+    int year, month, day;
+    _civil_from_days(_divl(usec + zone->std_offset * USEC_IN_MINUTE, USEC_IN_DAY) - D_DAYS_BEFORE_UNIX_EPOCH, &year, &month, &day);
+    long long start, end;
+    switch (zone->dst_rule)
+    {
+        case D_DST_EU:
+            start = (_days_from_civil(year, 3, _nth_sunday(year, 3, -1)) + D_DAYS_BEFORE_UNIX_EPOCH) * USEC_IN_DAY + 60 * USEC_IN_MINUTE;
+            end = (_days_from_civil(year, 10, _nth_sunday(year, 10, -1)) + D_DAYS_BEFORE_UNIX_EPOCH) * USEC_IN_DAY + 60 * USEC_IN_MINUTE;
+            break;
+        case D_DST_US:
+            start = (_days_from_civil(year, 3, _nth_sunday(year, 3, 2)) + D_DAYS_BEFORE_UNIX_EPOCH) * USEC_IN_DAY
+                + (120 - zone->std_offset) * USEC_IN_MINUTE;
+            end = (_days_from_civil(year, 11, _nth_sunday(year, 11, 1)) + D_DAYS_BEFORE_UNIX_EPOCH) * USEC_IN_DAY
+                + (120 - zone->std_offset - 60) * USEC_IN_MINUTE;
+            break;
+        default:
+            return zone->std_offset;
+    }
+    return zone->std_offset + (usec >= start && usec < end ? 60 : 0);
+}
+
+long long zone_next_local_time(const time_zone_t* zone, long long after, int minute_of_day, int weekdays)
+{
+    static const long long USEC_IN_DAY = 86400000000L;
+    static const long long USEC_IN_MINUTE = 60000000L;
+
+    // Days are counted from 0000-01-01, which was Saturday
+    long long today = _divl(after + zone_offset_at(zone, after) * USEC_IN_MINUTE, USEC_IN_DAY);
+    // Yesterday's local time can still be ahead when the offset is about to decrease
+    for (long long day = today - 1; day <= today + 8; day++)
+    {
+        if (!(weekdays & (1 << _modl(day + 5, 7)))) continue;
+        long long usec = _zone_local_time(zone, day, minute_of_day);
+        if (usec > after) return usec;
+    }
+    return after;
+}
@@ -1,13 +1,18 @@
 /*! \file */
 
+#include "datelocale.h"
+
 void dnprintf(date_t d, char* const buffer, size_t len, const char* format);
+void dnprintf_l(date_t d, char* const buffer, size_t len, const char* format, const d_locale_t* locale);
 int place_n_in_s(char* buffer, size_t len, long long num, char opt, short padd);
 int place_s_in_s(char* buffer, size_t len, char* str, char opt, short padd);
+int place_name_in_s(char* buffer, size_t len, d_name_t name, char opt, short padd);
 int convert_to_roman(unsigned int val, char *buf, size_t len);
 
 //! \cond foo
 #define PUT(NUM, OPT, PADD) j += place_n_in_s(buffer + j, len - j - 1, NUM, OPT, PADD)
 #define PUTS(STR, OPT, PADD) j += place_s_in_s(buffer + j, len - j - 1, STR, OPT, PADD)
+#define PUTN(NAME, OPT, PADD) j += place_name_in_s(buffer + j, len - j - 1, NAME, OPT, PADD)
 //! \endcond
 
 #define F_ISO_8601_T "%0Y-%0m-%0dT%0H:%0M:%0S.%0u%t%0Z:%0z"         //!< Example: 2015-06-11T21:53:12.543294091+02:00
@@ -34,6 +39,7 @@ int place_n_in_s(char* buffer, size_t len, long long num, char opt, short padd)
 {
     if (num < 0) padd++;
     if (opt == 0 || opt == '^') return snprintf(buffer, len, "%lld", num);
+    D_PROF_HIT(D_PROF_PLACE_N_STRDUP);
     char* f = strdup("% *lld");
     f[1] = opt;
     int ret = snprintf(buffer, len, f, padd, num);
@@ -52,6 +58,7 @@ int place_n_in_s(char* buffer, size_t len, long long num, char opt, short padd)
 int place_s_in_s(char* buffer, size_t len, char* str, char opt, short padd)
 {
     if (opt == 0 || opt == '^') return snprintf(buffer, len, "%s", str);
+    D_PROF_HIT(D_PROF_PLACE_S_STRDUP);
     char* f = strdup("% *s");
     f[1] = opt;
     int ret = snprintf(buffer, len, f, padd, str);
@@ -59,6 +66,32 @@ int place_s_in_s(char* buffer, size_t len, char* str, char opt, short padd)
     return ret;
 }
 
+//! Helper function to put a locale name inside of string buffer
+/*!
+    \param buffer string buffer
+    \param len size of the buffer
+    \param name name to put (its length is known, so no formatting is needed without padding)
+    \param opt optional formatting character (see dnprintf)
+    \param padd minimum number of code points to be printed; if the name is shorter than this number, it is padded with spaces
+*/
+int place_name_in_s(char* buffer, size_t len, d_name_t name, char opt, short padd)
+{
+    // Names are UTF-8, so count code points (bytes other than 10xxxxxx) rather than bytes
+    size_t chars = 0;
+    for (size_t i = 0; i < name.len; i++) chars += ((name.str[i] & 0xC0) != 0x80);
+    size_t fill = (opt != 0 && opt != '^' && padd > 0 && chars < (size_t)padd ? padd - chars : 0);
+    size_t n = (fill < len ? fill : len);
+    memset(buffer, ' ', n);
+    if (fill < len)
+    {
+        size_t m = (name.len < len - fill ? name.len : len - fill);
+        memcpy(buffer + fill, name.str, m);
+        n += m;
+    }
+    if (n < len) buffer[n] = 0;
+    return fill + name.len;
+}
+
 //! Convert a number to roman numeral string
 /*!
     \param val number to convert
@@ -67,11 +100,12 @@ int place_s_in_s(char* buffer, size_t len, char* str, char opt, short padd)
 */
 int convert_to_roman(unsigned int val, char *buf, size_t len)
 {
+    D_PROF_HIT(D_PROF_ROMAN);
     char *init = buf;
-    char *huns[] = {"", "C", "CC", "CCC", "CD", "D", "DC", "DCC", "DCCC", "CM"};
-    char *tens[] = {"", "X", "XX", "XXX", "XL", "L", "LX", "LXX", "LXXX", "XC"};
-    char *ones[] = {"", "I", "II", "III", "IV", "V", "VI", "VII", "VIII", "IX"};
-    int size[] = {0, 1, 2, 3, 2, 1, 2, 3, 4, 2};
+    const char *huns[] = {"", "C", "CC", "CCC", "CD", "D", "DC", "DCC", "DCCC", "CM"};
+    const char *tens[] = {"", "X", "XX", "XXX", "XL", "L", "LX", "LXX", "LXXX", "XC"};
+    const char *ones[] = {"", "I", "II", "III", "IV", "V", "VI", "VII", "VIII", "IX"};
+    size_t size[] = {0, 1, 2, 3, 2, 1, 2, 3, 4, 2};
 
     while (val >= 1000) {
         if (len-- < 1) return 0;
@@ -126,6 +160,7 @@ Interpreted sequences of `format' are:
 - \%d – day of the month                
 - \%a – abbreviated name of the month (3 characters)
 - \%A – full name of the month
+- \%G – full name of the month in genitive (same as %A in locales which do not inflect month names)
 - \%r – month as a Roman numeral (I..XII)
 - \%R – year as a Roman numeral
 - \%b – abbreviated name of the weekday (3 characters)
@@ -150,12 +185,30 @@ Optional flags may follow `\%':
 - `0' – pad with zeros
 - ` ' – (a space) pad with spaces
 `-' – left justify within a given field
+
+Names are in English, see dnprintf_l for other locales.
 */
 void dnprintf(date_t d, char* const buffer, size_t len, const char* format)
 {
+    dnprintf_l(d, buffer, len, format, D_LOCALE_EN);
+}
+
+//! Create a date string with format, using names from a locale
+/*!
+    \param d date to create a string from
+    \param buffer buffer in which the string is to be created
+    \param len size of the buffer
+    \param format format string (see dnprintf)
+    \param locale locale to take month, weekday, AM/PM and era names from, or NULL for English
+    (so that the result of d_locale_find can be passed directly)
+*/
+void dnprintf_l(date_t d, char* const buffer, size_t len, const char* format, const d_locale_t* locale)
+{
+    D_PROF_BEGIN(D_PROF_DNPRINTF);
+    if (locale == NULL) locale = D_LOCALE_EN;
     size_t f_len = strlen(format);
     int j = 0;
-    for (int i = 0; i < f_len; i++)
+    for (size_t i = 0; i < f_len; i++)
     {
         char c = format[i];
         if (c != '%')
@@ -190,21 +243,22 @@ void dnprintf(date_t d, char* const buffer, size_t len, const char* format)
                 case 'm': PUT(d.month, opt, 2*(opt != 0)); break;
                 case 'd': PUT(d.day, opt, 2*(opt != 0)); break;
                 
-                case 'a': PUTS((char*)D_MONTH_ABBRV[d.month - 1], opt, 3*(opt != 0)); break;
-                case 'A': PUTS((char*)D_MONTH_NAMES[d.month - 1], opt, 9*(opt != 0)); break;
+                case 'a': PUTN(locale->month_abbrv[D_MONTH_INDEX(d.month)], opt, 3*(opt != 0)); break;
+                case 'A': PUTN(locale->month_names[D_MONTH_INDEX(d.month)], opt, 9*(opt != 0)); break;
+                case 'G': PUTN(locale->month_genitive[D_MONTH_INDEX(d.month)], opt, 9*(opt != 0)); break;
                 case 'r': j += convert_to_roman(d.month, buffer + j, len - j - 1); break;
                 case 'R': j += convert_to_roman((d.year <= 0 ? - d.year + 1 : d.year), buffer + j, len - j - 1); break;
-                case 'b': PUTS((char*)D_WEEKDAY_ABBRV[d.weekday], opt, 3*(opt != 0)); break;
-                case 'B': PUTS((char*)D_WEEKDAY_NAMES[d.weekday], opt, 3*(opt != 0)); break;
+                case 'b': PUTN(locale->weekday_abbrv[D_WEEKDAY_INDEX(d.weekday)], opt, 3*(opt != 0)); break;
+                case 'B': PUTN(locale->weekday_names[D_WEEKDAY_INDEX(d.weekday)], opt, 3*(opt != 0)); break;
                 case 'w': PUT(d.weekday + 1, opt, (opt != 0)); break;
                 case 'v': PUT((d.weekday + 1) % 7, opt, (opt != 0)); break;
                 case 'c': PUT(abs(century(d.year)), opt, 2*(opt != 0)); break;
                 case 'C': j += convert_to_roman(abs(century(d.year)), buffer + j, len - j); break;
-                case 'L': PUTS((char*)D_ADBC[d.year <= 0], opt, 2*(opt != 0)); break;
+                case 'L': PUTN(locale->era[d.year <= 0], opt, 2*(opt != 0)); break;
                 case 'l': PUTS((char*)D_PLUSMINUS[d.year <= 0], opt, (opt != 0)); break;
                 case 'W': PUT(iso_week_number(d), opt, 2*(opt != 0)); break;
-                case 'p': PUTS((char*)D_AMPM_SMALL[d.hour/12], opt, 3*(opt != 0)); break;
-                case 'P': PUTS((char*)D_AMPM_CAPS[d.hour/12], opt, 3*(opt != 0)); break;
+                case 'p': PUTN(locale->ampm_small[d.hour/12], opt, 3*(opt != 0)); break;
+                case 'P': PUTN(locale->ampm_caps[d.hour/12], opt, 3*(opt != 0)); break;
                 
                 case 't': PUTS((char*)D_PLUSMINUS[d.tz_offset < 0], opt, (opt != 0)); break;
                 case 'Z': PUT(abs(d.tz_offset) / 60, opt, 2*(opt != 0)); break;
@@ -214,4 +268,5 @@ void dnprintf(date_t d, char* const buffer, size_t len, const char* format)
         }
     }
     buffer[j] = 0;
+    D_PROF_END(D_PROF_DNPRINTF);
 }
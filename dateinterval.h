@@ -0,0 +1,522 @@
+/*! \file
+    \brief Sets of time intervals
+
+    Instants are microseconds since 0000-01-01 00:00 UTC (see date_to_usec_since_zero), and all
+    intervals are half-open: [start, end).
+*/
+
+//! Time interval [start, end)
+typedef struct
+{
+    long long start;
+    long long end;
+} interval_t;
+
+/*! \brief Set of instants, kept as a sorted array of disjoint intervals
+
+    Touching and overlapping intervals are always coalesced, so two sets are equal exactly when
+    their arrays are equal. Initialise with {0} or interval_set_init.
+*/
+typedef struct
+{
+    interval_t* items;
+    size_t count;
+    size_t capacity;
+} interval_set_t;
+
+//! Number of length classes of an interval index: each class spans two bit lengths
+#define D_INTERVAL_CLASSES 32
+
+/*! \brief Static index of (possibly overlapping) intervals, for overlap queries
+
+    Intervals are grouped by length class, and sorted by start within each class; items of class c
+    are [class_start[c], class_start[c + 1]). max_end is an implicit binary tree over each class,
+    with the maximum end of each subtree stored in the subtree's root. Since lengths within a class
+    differ by less than a factor of four, a few long intervals cannot make the search of the short
+    ones visit subtrees which have no overlapping interval.
+*/
+typedef struct
+{
+    interval_t* items;
+    long long* max_end;
+    size_t count;
+    size_t class_start[D_INTERVAL_CLASSES + 1];
+    int root_level[D_INTERVAL_CLASSES];
+} interval_index_t;
+
+//! Create an interval from two dates
+interval_t make_interval(date_t start, date_t end);
+
+void interval_set_init(interval_set_t* set);
+void interval_set_free(interval_set_t* set);
+//! Remove all intervals, keeping the allocated memory
+void interval_set_clear(interval_set_t* set);
+//! \brief Add [start, end) to a set
+//! \details Appending after the last interval is O(1), otherwise it is O(n).
+//! \returns false if memory could not be allocated
+bool interval_set_add(interval_set_t* set, long long start, long long end);
+//! \brief Make a set from an array of intervals in any order in O(n log n)
+//! \returns false if memory could not be allocated
+bool interval_set_from_array(interval_set_t* set, const interval_t* intervals, size_t count);
+//! \brief Union of two sets in O(n + m) (out must be different from a and b)
+//! \returns false if memory could not be allocated
+bool interval_set_union(interval_set_t* out, const interval_set_t* a, const interval_set_t* b);
+//! \brief Intersection of two sets in O(n + m) (out must be different from a and b)
+//! \returns false if memory could not be allocated
+bool interval_set_intersection(interval_set_t* out, const interval_set_t* a, const interval_set_t* b);
+//! \brief Difference a - b of two sets in O(n + m) (out must be different from a and b)
+//! \returns false if memory could not be allocated
+bool interval_set_difference(interval_set_t* out, const interval_set_t* a, const interval_set_t* b);
+//! Check whether an instant belongs to a set, in O(log n)
+bool interval_set_contains(const interval_set_t* set, long long t);
+//! Like interval_set_contains, but the search compiles to conditional moves instead of branches
+bool interval_set_contains_branchless(const interval_set_t* set, long long t);
+//! Total length of a set in microseconds
+long long interval_set_duration(const interval_set_t* set);
+//! Length of the intersection of a set with [start, end) in microseconds, in O(log n + k)
+long long interval_set_duration_between(const interval_set_t* set, long long start, long long end);
+/*! \brief Add a daily time range on selected weekdays between two dates
+
+    For every local day of a time zone between `from` and `to` whose weekday is in `weekdays`,
+    [start_minute, end_minute) of that day's local time is added, clipped to [from, to).
+    `end_minute` can be more than 1440 for ranges which end the next day. Local times follow
+    the zone's daylight saving time (see zone_next_local_time for skipped and repeated times).
+    For example, business hours of every weekday in 2027 in Warsaw:
+
+        time_zone_t warsaw = D_ZONE_CENTRAL_EUROPE;
+        interval_set_add_weekly(&set, make_date(2027, 1, 1, 0, 0, 0, 0, 60),
+            make_date(2028, 1, 1, 0, 0, 0, 0, 60), &warsaw, D_WORKDAYS, 9 * 60, 17 * 60);
+
+    A fixed offset is a zone without daylight saving time, e.g. {60, D_DST_NONE, NULL, NULL}.
+    \returns false if memory could not be allocated
+*/
+bool interval_set_add_weekly(interval_set_t* set, date_t from, date_t to, const time_zone_t* zone, int weekdays, int start_minute, int end_minute);
+
+//! \brief Build an index of intervals in any order, overlapping or not, in O(n log n)
+//! \returns false if memory could not be allocated
+bool interval_index_build(interval_index_t* index, const interval_t* intervals, size_t count);
+void interval_index_free(interval_index_t* index);
+/*! \brief Find the intervals of an index which overlap [start, end)
+
+    A query costs O(C log N + k + m) for C non-empty length classes and k intervals found, where
+    m is about the number of intervals which start less than four times their own length before
+    `start` but do not overlap the query; for intervals spread evenly in time m is a few times k.
+    \param index index to search
+    \param start start of the query interval
+    \param end end of the query interval
+    \param out array for the positions (in index->items) of the overlapping intervals, in ascending order
+    \param len size of out; only the first len positions are stored
+    \returns Number of overlapping intervals (can be greater than len)
+*/
+size_t interval_index_overlap(const interval_index_t* index, long long start, long long end, size_t* out, size_t len);
+
+interval_t make_interval(date_t start, date_t end)
+{
+    interval_t interval = {date_to_usec_since_zero(start), date_to_usec_since_zero(end)};
+    return interval;
+}
+
+void interval_set_init(interval_set_t* set)
+{
+    set->items = NULL;
+    set->count = 0;
+    set->capacity = 0;
+}
+
+void interval_set_free(interval_set_t* set)
+{
+    free(set->items);
+    interval_set_init(set);
+}
+
+void interval_set_clear(interval_set_t* set)
+{
+    set->count = 0;
+}
+
+//! Make sure that a set has space for at least `capacity` intervals
+bool _interval_set_reserve(interval_set_t* set, size_t capacity)
+{
+    if (capacity <= set->capacity) return true;
+    if (capacity < 2 * set->capacity) capacity = 2 * set->capacity;
+    if (capacity < 8) capacity = 8;
+    interval_t* items = (interval_t*)realloc(set->items, capacity * sizeof(interval_t));
+    if (items == NULL) return false;
+    set->items = items;
+    set->capacity = capacity;
+    return true;
+}
+
+//! Append an interval which does not start before the last one, coalescing them if needed
+bool _interval_set_append(interval_set_t* set, long long start, long long end)
+{
+    if (start >= end) return true;
+    if (set->count > 0 && start <= set->items[set->count - 1].end)
+    {
+        if (end > set->items[set->count - 1].end) set->items[set->count - 1].end = end;
+        return true;
+    }
+    if (!_interval_set_reserve(set, set->count + 1)) return false;
+    set->items[set->count].start = start;
+    set->items[set->count].end = end;
+    set->count++;
+    return true;
+}
+
+bool interval_set_add(interval_set_t* set, long long start, long long end)
+{
+    if (start >= end) return true;
+    if (set->count == 0 || start >= set->items[set->count - 1].start) return _interval_set_append(set, start, end);
+
+    // [lo, hi) are the intervals which touch or overlap [start, end)
+    size_t lo = 0, hi = set->count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (set->items[mid].end < start) lo = mid + 1;
+        else hi = mid;
+    }
+    hi = lo;
+    while (hi < set->count && set->items[hi].start <= end) hi++;
+
+    if (lo == hi)
+    {
+        if (!_interval_set_reserve(set, set->count + 1)) return false;
+        memmove(set->items + lo + 1, set->items + lo, (set->count - lo) * sizeof(interval_t));
+        set->count++;
+    }
+    else
+    {
+        if (set->items[lo].start < start) start = set->items[lo].start;
+        if (set->items[hi - 1].end > end) end = set->items[hi - 1].end;
+        memmove(set->items + lo + 1, set->items + hi, (set->count - hi) * sizeof(interval_t));
+        set->count -= hi - lo - 1;
+    }
+    set->items[lo].start = start;
+    set->items[lo].end = end;
+    return true;
+}
+
+//! Comparison function for qsort, by start
+int _interval_compare(const void* a, const void* b)
+{
+    long long sa = ((const interval_t*)a)->start;
+    long long sb = ((const interval_t*)b)->start;
+    return (sa > sb) - (sa < sb);
+}
+
+bool interval_set_from_array(interval_set_t* set, const interval_t* intervals, size_t count)
+{
+    interval_set_clear(set);
+    if (count == 0) return true;
+    if (!_interval_set_reserve(set, count)) return false;
+    memcpy(set->items, intervals, count * sizeof(interval_t));
+    qsort(set->items, count, sizeof(interval_t), _interval_compare);
+
+    // Coalesce in place
+    size_t j = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        interval_t it = set->items[i];
+        if (it.start >= it.end) continue;
+        if (j > 0 && it.start <= set->items[j - 1].end)
+        {
+            if (it.end > set->items[j - 1].end) set->items[j - 1].end = it.end;
+        }
+        else set->items[j++] = it;
+    }
+    set->count = j;
+    return true;
+}
+
+bool interval_set_union(interval_set_t* out, const interval_set_t* a, const interval_set_t* b)
+{
+    interval_set_clear(out);
+    if (!_interval_set_reserve(out, a->count + b->count)) return false;
+    size_t i = 0, j = 0;
+    while (i < a->count || j < b->count)
+    {
+        const interval_t* it;
+        if (j == b->count || (i < a->count && a->items[i].start <= b->items[j].start)) it = &a->items[i++];
+        else it = &b->items[j++];
+        _interval_set_append(out, it->start, it->end);
+    }
+    return true;
+}
+
+bool interval_set_intersection(interval_set_t* out, const interval_set_t* a, const interval_set_t* b)
+{
+    interval_set_clear(out);
+    if (!_interval_set_reserve(out, a->count + b->count)) return false;
+    size_t i = 0, j = 0;
+    while (i < a->count && j < b->count)
+    {
+        long long start = (a->items[i].start > b->items[j].start ? a->items[i].start : b->items[j].start);
+        long long end = (a->items[i].end < b->items[j].end ? a->items[i].end : b->items[j].end);
+        _interval_set_append(out, start, end);
+        if (a->items[i].end < b->items[j].end) i++;
+        else j++;
+    }
+    return true;
+}
+
+bool interval_set_difference(interval_set_t* out, const interval_set_t* a, const interval_set_t* b)
+{
+    interval_set_clear(out);
+    if (!_interval_set_reserve(out, a->count + b->count)) return false;
+    size_t j = 0;
+    for (size_t i = 0; i < a->count; i++)
+    {
+        long long start = a->items[i].start;
+        long long end = a->items[i].end;
+        while (j < b->count && b->items[j].end <= start) j++;
+        // Cut out every interval of b which overlaps the rest of [start, end)
+        size_t k = j;
+        while (k < b->count && b->items[k].start < end)
+        {
+            _interval_set_append(out, start, b->items[k].start);
+            start = b->items[k].end;
+            if (start >= end) break;
+            k++;
+        }
+        _interval_set_append(out, start, end);
+    }
+    return true;
+}
+
+bool interval_set_contains(const interval_set_t* set, long long t)
+{
+    size_t lo = 0, hi = set->count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (t < set->items[mid].start) hi = mid;
+        else if (t >= set->items[mid].end) lo = mid + 1;
+        else return true;
+    }
+    return false;
+}
+
+bool interval_set_contains_branchless(const interval_set_t* set, long long t)
+{
+    if (set->count == 0) return false;
+    const interval_t* base = set->items;
+    size_t n = set->count;
+    while (n > 1)
+    {
+        size_t half = n / 2;
+        base = (base[half].start <= t ? base + half : base);
+        n -= half;
+    }
+    return (base->start <= t) & (t < base->end);
+}
+
+long long interval_set_duration(const interval_set_t* set)
+{
+    long long duration = 0;
+    for (size_t i = 0; i < set->count; i++) duration += set->items[i].end - set->items[i].start;
+    return duration;
+}
+
+long long interval_set_duration_between(const interval_set_t* set, long long start, long long end)
+{
+    if (start >= end) return 0;
+    size_t lo = 0, hi = set->count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (set->items[mid].end <= start) lo = mid + 1;
+        else hi = mid;
+    }
+
+    long long duration = 0;
+    for (size_t i = lo; i < set->count && set->items[i].start < end; i++)
+    {
+        long long s = (set->items[i].start > start ? set->items[i].start : start);
+        long long e = (set->items[i].end < end ? set->items[i].end : end);
+        duration += e - s;
+    }
+    return duration;
+}
+
+bool interval_set_add_weekly(interval_set_t* set, date_t from, date_t to, const time_zone_t* zone, int weekdays, int start_minute, int end_minute)
+{
+    static const long long USEC_IN_DAY = 86400000000L;
+    static const long long USEC_IN_MINUTE = 60000000L;
+
+    long long from_usec = date_to_usec_since_zero(from);
+    long long to_usec = date_to_usec_since_zero(to);
+
+    // Local days are counted from 0000-01-01, which was Saturday
+    long long day = _divl(from_usec + zone_offset_at(zone, from_usec) * USEC_IN_MINUTE, USEC_IN_DAY);
+    for (; _zone_local_time(zone, day, 0) < to_usec; day++)
+    {
+        if (!(weekdays & (1 << _modl(day + 5, 7)))) continue;
+        long long start = _zone_local_time(zone, day, start_minute);
+        long long end = _zone_local_time(zone, day, end_minute);
+        if (start < from_usec) start = from_usec;
+        if (end > to_usec) end = to_usec;
+        if (!interval_set_add(set, start, end)) return false;
+    }
+    return true;
+}
+
+//! Length class of an interval: half the bit length of end - start rounded up, or 0 for an empty interval
+int _interval_class(const interval_t* interval)
+{
+    if (interval->end <= interval->start) return 0;
+    int c = (65 - __builtin_clzll((unsigned long long)interval->end - (unsigned long long)interval->start)) / 2;
+    return (c < D_INTERVAL_CLASSES ? c : D_INTERVAL_CLASSES - 1);
+}
+
+//! Fill max_end for the intervals a[0..count) sorted by start, and return the level of the root
+int _interval_tree_build(const interval_t* a, long long* max_end, size_t count)
+{
+    if (count == 0) return -1;
+
+    // Leaves are at even positions; the node at level k is at positions 2^k - 1 + i * 2^(k + 1).
+    // `last` is the maximum end of the rightmost subtree, used for children past the end of the array.
+    size_t i, last_i = 0;
+    long long last = 0;
+    for (i = 0; i < count; i += 2)
+    {
+        last_i = i;
+        last = max_end[i] = a[i].end;
+    }
+
+    int k;
+    for (k = 1; ((size_t)1 << k) <= count; k++)
+    {
+        size_t x = (size_t)1 << (k - 1);
+        for (i = (x << 1) - 1; i < count; i += x << 2)
+        {
+            long long e = a[i].end;
+            long long left = max_end[i - x];
+            long long right = (i + x < count ? max_end[i + x] : last);
+            if (left > e) e = left;
+            if (right > e) e = right;
+            max_end[i] = e;
+        }
+        last_i = ((last_i >> k) & 1 ? last_i - x : last_i + x);
+        if (last_i < count && max_end[last_i] > last) last = max_end[last_i];
+    }
+    return k - 1;
+}
+
+bool interval_index_build(interval_index_t* index, const interval_t* intervals, size_t count)
+{
+    index->items = (interval_t*)malloc(count * sizeof(interval_t) + 1);
+    index->max_end = (long long*)malloc(count * sizeof(long long) + 1);
+    index->count = count;
+    if (index->items == NULL || index->max_end == NULL)
+    {
+        interval_index_free(index);
+        return false;
+    }
+
+    // Group the intervals by class, then sort each class by start
+    size_t next[D_INTERVAL_CLASSES];
+    size_t i;
+    int c;
+    for (c = 0; c <= D_INTERVAL_CLASSES; c++) index->class_start[c] = 0;
+    for (i = 0; i < count; i++) index->class_start[_interval_class(&intervals[i]) + 1]++;
+    for (c = 0; c < D_INTERVAL_CLASSES; c++)
+    {
+        index->class_start[c + 1] += index->class_start[c];
+        next[c] = index->class_start[c];
+    }
+    for (i = 0; i < count; i++) index->items[next[_interval_class(&intervals[i])]++] = intervals[i];
+
+    for (c = 0; c < D_INTERVAL_CLASSES; c++)
+    {
+        size_t first = index->class_start[c], n = index->class_start[c + 1] - first;
+        qsort(index->items + first, n, sizeof(interval_t), _interval_compare);
+        index->root_level[c] = _interval_tree_build(index->items + first, index->max_end + first, n);
+    }
+    return true;
+}
+
+void interval_index_free(interval_index_t* index)
+{
+    free(index->items);
+    free(index->max_end);
+    index->items = NULL;
+    index->max_end = NULL;
+    index->count = 0;
+    for (int c = 0; c < D_INTERVAL_CLASSES; c++)
+    {
+        index->class_start[c + 1] = 0;
+        index->root_level[c] = -1;
+    }
+    index->class_start[0] = 0;
+}
+
+//! Search one class of an index, appending the positions found to out[found..len)
+size_t _interval_index_overlap_class(const interval_index_t* index, int c, long long start, long long end, size_t* out, size_t len, size_t found)
+{
+    struct { int level; bool left_done; size_t x; } stack[128];
+    size_t first = index->class_start[c], n = index->class_start[c + 1] - first;
+    const interval_t* a = index->items + first;
+    const long long* max_end = index->max_end + first;
+    int top = 0;
+
+    if (index->root_level[c] < 0) return found;
+    stack[top].level = index->root_level[c];
+    stack[top].left_done = false;
+    stack[top++].x = ((size_t)1 << index->root_level[c]) - 1;
+
+    while (top > 0)
+    {
+        int k = stack[--top].level;
+        bool left_done = stack[top].left_done;
+        size_t x = stack[top].x;
+
+        if (k <= 3)
+        {
+            // Small subtree, scan all of it
+            size_t i = x >> k << k;
+            size_t i_end = i + ((size_t)1 << (k + 1)) - 1;
+            if (i_end > n) i_end = n;
+            for (; i < i_end && a[i].start < end; i++)
+            {
+                if (start < a[i].end)
+                {
+                    if (found < len) out[found] = first + i;
+                    found++;
+                }
+            }
+        }
+        else if (!left_done)
+        {
+            size_t y = x - ((size_t)1 << (k - 1));
+            stack[top].level = k;
+            stack[top].left_done = true;
+            stack[top++].x = x;
+            if (y >= n || max_end[y] > start)
+            {
+                stack[top].level = k - 1;
+                stack[top].left_done = false;
+                stack[top++].x = y;
+            }
+        }
+        else if (x < n && a[x].start < end)
+        {
+            if (start < a[x].end)
+            {
+                if (found < len) out[found] = first + x;
+                found++;
+            }
+            stack[top].level = k - 1;
+            stack[top].left_done = false;
+            stack[top++].x = x + ((size_t)1 << (k - 1));
+        }
+    }
+    return found;
+}
+
+size_t interval_index_overlap(const interval_index_t* index, long long start, long long end, size_t* out, size_t len)
+{
+    size_t found = 0;
+    for (int c = 0; c < D_INTERVAL_CLASSES; c++) found = _interval_index_overlap_class(index, c, start, end, out, len, found);
+    return found;
+}
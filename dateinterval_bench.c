@@ -0,0 +1,71 @@
+// Load benchmark of the interval index: overlap queries over ten million ranges.
+// Build with: cc -O2 dateinterval_bench.c -o dateinterval_bench -lm
+
+#include "datecal.h"
+#include "dateinterval.h"
+
+#define RANGES 10000000
+#define QUERIES 100000
+#define MINUTE 60000000LL
+#define YEAR (365 * 24 * 60 * MINUTE)
+
+interval_t ranges[RANGES];
+size_t out[100000];
+
+double seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+long long random_below(long long n)
+{
+    return ((((long long)rand() << 31) ^ rand()) & 0x3FFFFFFFFFFFFFFFLL) % n;
+}
+
+//! Index the ranges and run one-minute queries at random instants of the year
+void run(const char* what, long long start)
+{
+    interval_index_t index;
+    double t = seconds();
+    interval_index_build(&index, ranges, RANGES);
+    double build = seconds() - t;
+
+    srand(2);
+    size_t found = 0;
+    t = seconds();
+    for (size_t i = 0; i < QUERIES; i++)
+    {
+        long long s = start + random_below(YEAR);
+        found += interval_index_overlap(&index, s, s + MINUTE, out, sizeof(out) / sizeof(out[0]));
+    }
+    double elapsed = seconds() - t;
+    printf("%-40s build %6.2f s, queries %8.3f s %10.1f ns/query, %8.1f hits/query\n",
+        what, build, elapsed, elapsed * 1e9 / QUERIES, (double)found / QUERIES);
+    interval_index_free(&index);
+}
+
+int main(int argc, char** argv)
+{
+    long long start = date_to_usec_since_zero(make_date(2027, 1, 1, 0, 0, 0, 0, 0));
+    printf("%d ranges over a year, %d one-minute queries\n\n", RANGES, QUERIES);
+
+    srand(1);
+    for (size_t i = 0; i < RANGES; i++)
+    {
+        ranges[i].start = start + random_below(YEAR);
+        ranges[i].end = ranges[i].start + random_below(10 * MINUTE);
+    }
+    run("ranges up to 10 minutes long", start);
+
+    // Every thousandth range lasts a month
+    for (size_t i = 0; i < RANGES; i += 1000) ranges[i].end = ranges[i].start + 30 * 24 * 60 * MINUTE;
+    run("with 0.1% month-long ranges", start);
+
+    // Lengths spread over all scales, from a second to a day
+    for (size_t i = 0; i < RANGES; i++) ranges[i].end = ranges[i].start + (1000000LL << random_below(17));
+    run("lengths from a second to a day", start);
+
+    return 0;
+}
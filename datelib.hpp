@@ -0,0 +1,531 @@
+/*! \file
+    \brief C++20 layer over datecal.h and dateformat.h
+
+    Calendar functions are constexpr, and format strings are parsed at compile time:
+
+        char buffer[datelib::formatter<F_ISO_8601_T>::max_length + 1];
+        datelib::format_to<F_ISO_8601_T>(buffer, date);
+
+    An unknown conversion in the format string is a compile error. Each format compiles into a
+    sequence of writes specialized for its conversions, and its output is never longer than
+    formatter<...>::max_length, so the buffer is not checked at runtime. Output is the same as
+    dnprintf's (with English names), for dates normalized by make_date/fix_date; this includes %W
+    and %F, which follow dnprintf rather than iso_week_number (see dnprintf_iso_week_number).
+*/
+
+#include "datecal.h"
+#include "dateformat.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+namespace datelib
+{
+
+//! Modulo function, works with negative numbers (like _modl)
+constexpr long long floor_mod(long long a, long long b)
+{
+    if (a >= 0 || a % b == 0) return a % b;
+    else return a % b + b;
+}
+
+//! Integer division, for negative numbers quotient rounded towards infinity (like _divl)
+constexpr long long floor_div(long long a, long long b)
+{
+    if (a >= 0 || a % b == 0) return a / b;
+    else return a / b - 1;
+}
+
+constexpr bool is_leap_year(int year)
+{
+    if (year % 4 != 0) return false;
+    else if (year % 100 != 0) return true;
+    else if (year % 400 != 0) return false;
+    else return true;
+}
+
+//! Number of days in a year
+constexpr int year_length(int year)
+{
+    return 365 + (is_leap_year(year) ? 1 : 0);
+}
+
+//! Number of days in a month (1..12) of a year
+constexpr int month_length(int year, int month)
+{
+    constexpr int lengths[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return lengths[month - 1] + (month == 2 && is_leap_year(year) ? 1 : 0);
+}
+
+//! Number of the day in a year (January 1 is a first day)
+constexpr int day_of_year(int year, int month, int day)
+{
+    constexpr int before[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    return before[month - 1] + day + (month > 2 && is_leap_year(year) ? 1 : 0);
+}
+
+//! Number of the day in a year (January 1 is a first day)
+constexpr int day_of_year(const date_t& date)
+{
+    return day_of_year(date.year, date.month, date.day);
+}
+
+//! Number of days between 1970-01-01 and a date of the proleptic Gregorian calendar
+constexpr long long days_from_civil(int year, int month, int day)
+{
+    long long y = (long long)year - (month <= 2);
+    long long era = floor_div(y, 400);
+    long long year_of_era = y - era * 400;
+    long long day_of_era_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_era_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+//! Year, month and day
+struct civil_date
+{
+    int year;
+    int month;
+    int day;
+};
+
+//! Date of the proleptic Gregorian calendar a number of days after 1970-01-01
+constexpr civil_date civil_from_days(long long days)
+{
+    days += 719468;
+    long long era = floor_div(days, 146097);
+    long long day_of_era = days - era * 146097;
+    long long year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    long long day_of_era_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    long long m = (5 * day_of_era_year + 2) / 153;
+    int month = (int)(m < 10 ? m + 3 : m - 9);
+    return civil_date{(int)(year_of_era + era * 400 + (month <= 2)), month, (int)(day_of_era_year - (153 * m + 2) / 5 + 1)};
+}
+
+//! Weekday (0..6, where 0 is Monday) of a date of the proleptic Gregorian calendar
+constexpr int weekday(int year, int month, int day)
+{
+    return (int)floor_mod(days_from_civil(year, month, day) + 3, 7);
+}
+
+//! Get century from a year (like century in datecal.h)
+constexpr int century(int year)
+{
+    if (year < 0) return (-year) / 100 - 1;
+    return (year - 1) / 100 + 1;
+}
+
+//! Get day and month of easter in a year (like easter_in_year in datecal.h)
+constexpr date_t easter_in_year(date_t date)
+{
+    short a = (short)floor_mod(date.year, 19);
+    short b = (short)(date.year >> 2);
+    short c = (short)((b / 25) + 1);
+    short d = (short)((c * 3) >> 2);
+    short e = (short)floor_mod(((a * 19) - ((c * 8 + 5) / 25) + d + 15), 30);
+    e += (short)((29578 - a - e * 32) >> 10);
+    e -= (short)floor_mod((floor_mod(date.year, 7) + b - d + e + 2), 7);
+    d = (short)(e >> 5);
+    date.day = e - d * 31;
+    date.month = d + 3;
+    return date;
+}
+
+//! Number of leap years before a year (like leap_years_before in datecal.h)
+constexpr int leap_years_before(int year)
+{
+    year--;
+    return (year / 4) - (year / 100) + (year / 400);
+}
+
+//! Number of microseconds since 0000-01-01 00:00 given a date_t (like date_to_usec_since_zero in datecal.h)
+constexpr long long date_to_usec_since_zero(const date_t& date)
+{
+    long long time = (((long long)date.hour * 60 + date.minute - date.tz_offset) * 60 + date.second) * 1000000LL + date.usecond;
+    int year = date.year + (int)floor_div(date.month - 1, 12);
+    int month = (int)floor_mod(date.month - 1, 12) + 1;
+    long long days_since_zero = days_from_civil(year, month, 1) + D_DAYS_BEFORE_UNIX_EPOCH + date.day - 1;
+    return time + days_since_zero * 86400000000LL;
+}
+
+//! Create a date_t given number of microseconds since 0000-01-01 00:00 (like usec_since_zero_to_date in datecal.h)
+constexpr date_t usec_since_zero_to_date(long long usec, int tz_offset)
+{
+    date_t date {};
+
+    usec += tz_offset * 60000000LL;
+    date.tz_offset = tz_offset;
+
+    long long time_of_day = floor_mod(usec, 86400000000LL);
+    long long days_since_zero = floor_div(usec, 86400000000LL);
+
+    date.weekday = (int)floor_mod((days_since_zero + 5), 7); //0000-01-01 was Saturday
+
+    date.usecond = (int)(time_of_day % 1000000);
+    date.second = (int)((time_of_day / 1000000) % 60);
+    date.minute = (int)((time_of_day / 60000000) % 60);
+    date.hour = (int)(time_of_day / 3600000000LL);
+
+    civil_date civil = civil_from_days(days_since_zero - D_DAYS_BEFORE_UNIX_EPOCH);
+    date.year = civil.year;
+    date.month = civil.month;
+    date.day = civil.day;
+
+    return date;
+}
+
+//! Fix a broken date (like fix_date in datecal.h)
+constexpr date_t fix_date(date_t date)
+{
+    if (date.hour == 24) date.hour = 0;
+    return datelib::usec_since_zero_to_date(datelib::date_to_usec_since_zero(date), date.tz_offset);
+}
+
+//! ISO 8601 week number (1..53) of a date of the proleptic Gregorian calendar
+constexpr int iso_week_number(int year, int month, int day)
+{
+    // A week belongs to the year of its Thursday
+    long long thursday = days_from_civil(year, month, day) - weekday(year, month, day) + 3;
+    return (int)((thursday - days_from_civil(civil_from_days(thursday).year, 1, 1)) / 7 + 1);
+}
+
+//! ISO 8601 week number (1..53) of a date_t (the weekday field is not used)
+constexpr int iso_week_number(const date_t& date)
+{
+    return datelib::iso_week_number(date.year, date.month, date.day);
+}
+
+//! ISO 8601 week-numbering year of a date of the proleptic Gregorian calendar
+constexpr int iso_week_numbering_year(int year, int month, int day)
+{
+    return civil_from_days(days_from_civil(year, month, day) - weekday(year, month, day) + 3).year;
+}
+
+//! ISO 8601 week-numbering year of a date_t (the weekday field is not used)
+constexpr int iso_week_numbering_year(const date_t& date)
+{
+    return datelib::iso_week_numbering_year(date.year, date.month, date.day);
+}
+
+/*! \brief Week number as printed by dnprintf's %W (like iso_week_number in datecal.h)
+    \details The C function counts weeks from Thursday to Wednesday, starting with the first Thursday
+    of the year, so it often differs from the ISO week number. formatter uses this function to keep
+    format_to's output the same as dnprintf's; use iso_week_number for real ISO weeks.
+*/
+constexpr int dnprintf_iso_week_number(const date_t& date)
+{
+    date_t first_of_year = date;
+    first_of_year.day = 1;
+    first_of_year.month = 1;
+    first_of_year = datelib::fix_date(first_of_year);
+    first_of_year.day += (int)floor_mod((first_of_year.weekday - 3), 7);
+    first_of_year = datelib::fix_date(first_of_year);
+
+    if (datelib::date_to_usec_since_zero(first_of_year) > datelib::date_to_usec_since_zero(date))
+    {
+        return ((is_leap_year(date.year - 1)) ? 53 : 52);
+    }
+    else
+    {
+        return ((datelib::day_of_year(date) - first_of_year.day)/7 + 1);
+    }
+}
+
+//! Week-numbering year as printed by dnprintf's %F (like iso_week_numbering_year in datecal.h, see dnprintf_iso_week_number)
+constexpr int dnprintf_iso_week_numbering_year(const date_t& date)
+{
+    if ((date.month == 12) && (date.day - date.weekday + 1) > 27)
+    {
+        return date.year + 1;
+    }
+
+    if ((date.month == 1) && (date.weekday - date.day) > 3)
+    {
+        return date.year - 1;
+    }
+
+    return date.year;
+}
+
+//! \cond foo
+static_assert(days_from_civil(1970, 1, 1) == 0 && days_from_civil(2000, 3, 1) == 11017);
+static_assert(days_from_civil(0, 1, 1) == -719528 && days_from_civil(-1, 12, 31) == -719529);
+static_assert(civil_from_days(11017).year == 2000 && civil_from_days(11017).month == 3 && civil_from_days(11017).day == 1);
+static_assert(civil_from_days(-719529).year == -1 && civil_from_days(-719529).month == 12 && civil_from_days(-719529).day == 31);
+static_assert(weekday(1970, 1, 1) == 3 && weekday(2024, 1, 1) == 0 && weekday(2027, 1, 4) == 0 && weekday(2000, 2, 29) == 1);
+static_assert(iso_week_number(2021, 1, 3) == 53 && iso_week_numbering_year(2021, 1, 3) == 2020);
+static_assert(iso_week_number(2008, 12, 29) == 1 && iso_week_numbering_year(2008, 12, 29) == 2009);
+static_assert(iso_week_number(2026, 12, 31) == 53 && iso_week_number(2027, 1, 4) == 1 && iso_week_number(2024, 6, 15) == 24);
+static_assert(day_of_year(2024, 12, 31) == 366 && day_of_year(2023, 3, 1) == 60 && month_length(1900, 2) == 28);
+static_assert(century(2000) == 20 && century(2001) == 21 && leap_years_before(2001) == 485);
+static_assert(easter_in_year(date_t{2024}).month == 3 && easter_in_year(date_t{2024}).day == 31);
+static_assert(datelib::date_to_usec_since_zero(date_t{0, 1, 1}) == 0);
+static_assert(datelib::date_to_usec_since_zero(date_t{2029, 1, 1}) - datelib::date_to_usec_since_zero(date_t{2028, 12, 31}) == 86400000000LL);
+static_assert(datelib::usec_since_zero_to_date(datelib::date_to_usec_since_zero(date_t{2029, 1, 1}), 0).weekday == 0);
+static_assert(datelib::usec_since_zero_to_date(datelib::date_to_usec_since_zero(date_t{2024, 2, 29, 13}), 0).day == 29);
+//! \endcond
+
+//! English names, as in D_LOCALES[0]
+constexpr std::string_view WEEKDAY_NAMES[] = {"Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"};
+constexpr std::string_view WEEKDAY_ABBRV[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+constexpr std::string_view MONTH_NAMES[] = {"January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December"};
+constexpr std::string_view MONTH_ABBRV[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+constexpr std::string_view MONTH_ROMAN[] = {"I", "II", "III", "IV", "V", "VI", "VII", "VIII", "IX", "X", "XI", "XII"};
+constexpr std::string_view AMPM_CAPS[] = {"AM", "PM"};
+constexpr std::string_view AMPM_SMALL[] = {"a.m.", "p.m."};
+constexpr std::string_view ADBC[] = {"CE", "BCE"};
+constexpr std::string_view PLUSMINUS[] = {"+", "-"};
+
+//! Format string usable as a template argument
+template <std::size_t N>
+struct format_string
+{
+    char data[N] {};
+
+    constexpr format_string(const char (&str)[N])
+    {
+        for (std::size_t i = 0; i < N; i++) data[i] = str[i];
+    }
+
+    constexpr std::size_t size() const { return N - 1; }
+};
+
+//! Part of a parsed format string: a conversion, or a literal [begin, begin + length) of the format string
+struct format_token
+{
+    char conversion;    //!< Conversion character, 0 for literals
+    char opt;           //!< Optional formatting character (see dnprintf)
+    std::size_t begin;
+    std::size_t length;
+};
+
+//! \cond foo
+// Not constexpr, so calling them while parsing a format string is a compile error naming the problem
+void invalid_conversion_in_format_string();
+void unbounded_conversion_in_format_string();
+void incomplete_conversion_in_format_string();
+
+template <std::size_t N>
+struct parsed_format
+{
+    std::array<format_token, N> tokens {};
+    std::size_t count = 0;
+};
+//! \endcond
+
+/*! \brief Maximum number of characters written by a conversion
+    \details Hours, minutes, seconds, microseconds, days, months and weekdays are assumed to be
+    normalized; other fields can be any int.
+    \returns 0 for characters which are not conversions accepted by formatter
+*/
+constexpr std::size_t conversion_max_length(char conversion, char opt)
+{
+    auto number = [opt](std::size_t digits, std::size_t padd, bool can_be_negative) -> std::size_t
+    {
+        std::size_t sign = (can_be_negative || opt == '+' || opt == ' ' ? 1 : 0);
+        std::size_t width = (opt != 0 ? padd : 0) + can_be_negative;
+        return (digits + sign > width ? digits + sign : width);
+    };
+    auto name = [opt](const auto& names, std::size_t padd) -> std::size_t
+    {
+        std::size_t len = (opt != 0 ? padd : 0);
+        for (std::string_view n : names) len = (n.size() > len ? n.size() : len);
+        return len;
+    };
+
+    switch (conversion)
+    {
+        case '%': return 1;
+        case 'H': case 'I': case 'M': case 'S': case 'm': case 'd': case 'W': case 'j': case 'z': return number(2, 2, false);
+        case 'y': return number(2, 2, true);
+        case 's': return number(19, 12, true);
+        case 'u': return number(6, 6, false);
+        case 'Y': case 'F': return number(10, 4, true);
+        case 'J': return number(10, 4, false);
+        case 'w': case 'v': return number(1, 1, false);
+        case 'c': case 'Z': return number(8, 2, false);
+        case 'X': return number(10, 2, false);
+        case 'a': return name(MONTH_ABBRV, 3);
+        case 'A': case 'G': return name(MONTH_NAMES, 9);
+        case 'r': return name(MONTH_ROMAN, 0);
+        case 'b': return name(WEEKDAY_ABBRV, 3);
+        case 'B': return name(WEEKDAY_NAMES, 3);
+        case 'L': return name(ADBC, 2);
+        case 'l': case 't': return name(PLUSMINUS, 1);
+        case 'p': return name(AMPM_SMALL, 3);
+        case 'P': return name(AMPM_CAPS, 3);
+        default: return 0;
+    }
+}
+
+//! Parse a format string into tokens (see dnprintf for the syntax)
+template <format_string F>
+consteval auto parse_format()
+{
+    parsed_format<F.size() + 1> parsed;
+    std::size_t i = 0;
+    while (i < F.size())
+    {
+        if (F.data[i] != '%')
+        {
+            std::size_t begin = i;
+            while (i < F.size() && F.data[i] != '%') i++;
+            parsed.tokens[parsed.count++] = format_token{0, 0, begin, i - begin};
+            continue;
+        }
+
+        char opt = 0;
+        if (++i == F.size()) incomplete_conversion_in_format_string();
+        if (F.data[i] == '+' || F.data[i] == '0' || F.data[i] == ' ')
+        {
+            opt = F.data[i];
+            if (++i == F.size()) incomplete_conversion_in_format_string();
+        }
+
+        char c = F.data[i++];
+        if (c == 'R' || c == 'C') unbounded_conversion_in_format_string();
+        if (conversion_max_length(c, opt) == 0) invalid_conversion_in_format_string();
+        if (c == '%') parsed.tokens[parsed.count++] = format_token{0, 0, i - 1, 1};
+        else parsed.tokens[parsed.count++] = format_token{c, opt, 0, 0};
+    }
+    return parsed;
+}
+
+//! Tokens of a format string
+template <format_string F>
+consteval auto format_tokens()
+{
+    constexpr auto parsed = parse_format<F>();
+    std::array<format_token, parsed.count> tokens {};
+    for (std::size_t i = 0; i < parsed.count; i++) tokens[i] = parsed.tokens[i];
+    return tokens;
+}
+
+//! Formatter specialized for a format string
+template <format_string F>
+struct formatter
+{
+    static constexpr auto tokens = format_tokens<F>();
+
+    //! Maximum length of the output, without the terminating null character
+    static constexpr std::size_t max_length = []
+    {
+        std::size_t len = 0;
+        for (const format_token& t : tokens) len += (t.conversion == 0 ? t.length : conversion_max_length(t.conversion, t.opt));
+        return len;
+    }();
+
+    //! \brief Write a date to a buffer of at least max_length characters
+    //! \returns Number of characters written (no null character is added)
+    static std::size_t write(const date_t& d, char* buffer) noexcept
+    {
+        char* p = buffer;
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            (put<tokens[I]>(d, p), ...);
+        }(std::make_index_sequence<tokens.size()>());
+        return p - buffer;
+    }
+
+private:
+    //! Put a number like place_n_in_s
+    template <char OPT, short PADD>
+    static void put_number(long long num, char*& p) noexcept
+    {
+        bool negative = num < 0;
+        unsigned long long u = (negative ? 0ULL - (unsigned long long)num : (unsigned long long)num);
+        char digits[20];
+        int n = 0;
+        do
+        {
+            digits[n++] = '0' + u % 10;
+            u /= 10;
+        } while (u != 0);
+
+        char sign = (negative ? '-' : (OPT == '+' || OPT == ' ' ? OPT : 0));
+        int padding = 0;
+        if constexpr (OPT != 0) padding = PADD + negative - n - (sign != 0);
+
+        if constexpr (OPT != '0') for (; padding > 0; padding--) *p++ = ' ';
+        if (sign != 0) *p++ = sign;
+        if constexpr (OPT == '0') for (; padding > 0; padding--) *p++ = '0';
+        while (n > 0) *p++ = digits[--n];
+    }
+
+    //! Put a string like place_s_in_s
+    template <char OPT, short PADD>
+    static void put_name(std::string_view name, char*& p) noexcept
+    {
+        if constexpr (OPT != 0)
+        {
+            if (name.size() < (std::size_t)PADD)
+            {
+                std::memset(p, ' ', PADD - name.size());
+                p += PADD - name.size();
+            }
+        }
+        std::memcpy(p, name.data(), name.size());
+        p += name.size();
+    }
+
+    template <format_token T>
+    static void put(const date_t& d, char*& p) noexcept
+    {
+        constexpr char O = T.opt;
+        constexpr bool P = (T.opt != 0);
+
+        if constexpr (T.conversion == 0)
+        {
+            std::memcpy(p, F.data + T.begin, T.length);
+            p += T.length;
+        }
+        else if constexpr (T.conversion == 'H') put_number<O, 2*P>(d.hour, p);
+        else if constexpr (T.conversion == 'I') put_number<O, 2*P>((d.hour % 12 == 0 ? 12 : d.hour % 12), p);
+        else if constexpr (T.conversion == 'M') put_number<O, 2*P>(d.minute, p);
+        else if constexpr (T.conversion == 'S') put_number<O, 2*P>(d.second, p);
+        else if constexpr (T.conversion == 's') put_number<O, 12*P>(datelib::date_to_usec_since_zero(d)/1000000L, p);
+        else if constexpr (T.conversion == 'u') put_number<O, 6*P>(d.usecond, p);
+        else if constexpr (T.conversion == 'Y') put_number<O, 4*P>(d.year, p);
+        else if constexpr (T.conversion == 'y') put_number<O, 2*P>(d.year % 100, p);
+        else if constexpr (T.conversion == 'F') put_number<O, 4*P>(datelib::dnprintf_iso_week_numbering_year(d), p);
+        else if constexpr (T.conversion == 'J') put_number<O, 4*P>((d.year <= 0 ? - d.year + 1 : d.year), p);
+        else if constexpr (T.conversion == 'j') put_number<O, 2*P>((d.year <= 0 ? - d.year + 1 : d.year) % 100, p);
+        else if constexpr (T.conversion == 'm') put_number<O, 2*P>(d.month, p);
+        else if constexpr (T.conversion == 'd') put_number<O, 2*P>(d.day, p);
+        else if constexpr (T.conversion == 'a') put_name<O, 3*P>(MONTH_ABBRV[d.month - 1], p);
+        else if constexpr (T.conversion == 'A' || T.conversion == 'G') put_name<O, 9*P>(MONTH_NAMES[d.month - 1], p);
+        else if constexpr (T.conversion == 'r') put_name<0, 0>(MONTH_ROMAN[d.month - 1], p);
+        else if constexpr (T.conversion == 'b') put_name<O, 3*P>(WEEKDAY_ABBRV[d.weekday], p);
+        else if constexpr (T.conversion == 'B') put_name<O, 3*P>(WEEKDAY_NAMES[d.weekday], p);
+        else if constexpr (T.conversion == 'w') put_number<O, 1*P>(d.weekday + 1, p);
+        else if constexpr (T.conversion == 'v') put_number<O, 1*P>((d.weekday + 1) % 7, p);
+        else if constexpr (T.conversion == 'c') put_number<O, 2*P>(abs(century(d.year)), p);
+        else if constexpr (T.conversion == 'L') put_name<O, 2*P>(ADBC[d.year <= 0], p);
+        else if constexpr (T.conversion == 'l') put_name<O, 1*P>(PLUSMINUS[d.year <= 0], p);
+        else if constexpr (T.conversion == 'W') put_number<O, 2*P>(datelib::dnprintf_iso_week_number(d), p);
+        else if constexpr (T.conversion == 'p') put_name<O, 3*P>(AMPM_SMALL[d.hour/12], p);
+        else if constexpr (T.conversion == 'P') put_name<O, 3*P>(AMPM_CAPS[d.hour/12], p);
+        else if constexpr (T.conversion == 't') put_name<O, 1*P>(PLUSMINUS[d.tz_offset < 0], p);
+        else if constexpr (T.conversion == 'Z') put_number<O, 2*P>(abs(d.tz_offset) / 60, p);
+        else if constexpr (T.conversion == 'z') put_number<O, 2*P>(abs(d.tz_offset) % 60, p);
+        else if constexpr (T.conversion == 'X') put_number<O, 2*P>(abs(d.tz_offset), p);
+    }
+};
+
+/*! \brief Create a null-terminated date string with a format checked at compile time
+    \details The buffer has to be large enough for any date, which is checked at compile time.
+    \returns Length of the string
+*/
+template <format_string F, std::size_t N>
+std::size_t format_to(char (&buffer)[N], const date_t& d) noexcept
+{
+    static_assert(N > formatter<F>::max_length, "buffer is too small for this format");
+    std::size_t len = formatter<F>::write(d, buffer);
+    buffer[len] = 0;
+    return len;
+}
+
+} // namespace datelib
@@ -0,0 +1,54 @@
+// Checks datelib.hpp against the C library: format_to against dnprintf, and iso_week_number against strftime's %V.
+// Build with: c++ -std=c++20 -O2 datelib_demo.cpp -o datelib_demo
+
+#include "datelib.hpp"
+
+//! Format a date with format_to and with dnprintf, and print both if they differ
+template <datelib::format_string F>
+bool compare(const date_t& d)
+{
+    char expected[100];
+    char buffer[datelib::formatter<F>::max_length + 1];
+    dnprintf(d, expected, sizeof(expected), F.data);
+    datelib::format_to<F>(buffer, d);
+    if (strcmp(expected, buffer) == 0) return true;
+    printf(" - %s: dnprintf \"%s\", format_to \"%s\"\n", F.data, expected, buffer);
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    char buffer[datelib::formatter<F_ISO_8601_T>::max_length + 1];
+    datelib::format_to<F_ISO_8601_T>(buffer, make_date(2015, 6, 11, 21, 53, 12, 543294, 120));
+    printf("format_to<F_ISO_8601_T>: %s (at most %zu characters)\n\n", buffer, datelib::formatter<F_ISO_8601_T>::max_length);
+
+    // Every 3 days and 13 minutes over 2000 years, in a few time zones
+    size_t dates = 0, mismatches = 0;
+    const int zones[] = {0, 60, -300, 330};
+    for (long long usec = datelib::date_to_usec_since_zero(make_date(-200, 1, 1, 0, 0, 0, 0, 0));
+        usec < datelib::date_to_usec_since_zero(make_date(1800, 1, 1, 0, 0, 0, 0, 0)); usec += 260000000000LL + 1234567)
+    {
+        date_t d = usec_since_zero_to_date(usec, zones[dates % 4]);
+        dates++;
+        mismatches += !compare<F_ISO_8601_T>(d) + !compare<F_ISO_8601_WDATE>(d) + !compare<F_RFC_2822>(d)
+            + !compare<F_US_LONGER>(d) + !compare<"%+Y %0c %j %J %L %l %P %p %I %X %s %w %v %F">(d)
+            + !compare<"% a % A %0b %0B %r %+y %+d % m">(d);
+    }
+    printf("format_to vs dnprintf: %zu dates, %zu mismatches\n", dates, mismatches);
+
+    // Every day of 1900..2100 (strftime covers these through time_t)
+    size_t days = 0, wrong_weeks = 0;
+    for (time_t t = -2208988800LL; t < 4133980800LL; t += 86400, days++)
+    {
+        struct tm tm;
+        gmtime_r(&t, &tm);
+        char expected[16];
+        strftime(expected, sizeof(expected), "%G-W%V", &tm);
+        snprintf(buffer, sizeof(buffer), "%d-W%02d", datelib::iso_week_numbering_year(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday),
+            datelib::iso_week_number(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday));
+        if (strcmp(expected, buffer) != 0) wrong_weeks++;
+    }
+    printf("iso_week_number vs strftime: %zu days, %zu mismatches\n", days, wrong_weeks);
+
+    return (mismatches == 0 && wrong_weeks == 0 ? 0 : 1);
+}
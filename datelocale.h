@@ -0,0 +1,346 @@
+/*! \file */
+
+#include <ctype.h>
+
+//! Locale name table entry (string with its precomputed length in bytes)
+typedef struct
+{
+    const char* str;
+    size_t len;
+} d_name_t;
+
+//! \brief Locale used by dnprintf_l and the name matching functions
+//! \details All tables are immutable and precomputed, so a single locale can be shared between threads
+//! without any locking, and different threads can use different locales at the same time.
+typedef struct
+{
+    const char* code;               //!< Language code (e.g. "en", "pl")
+    d_name_t weekday_names[8];      //!< Full weekday names (0 is Monday, 7 is "Invalid")
+    d_name_t weekday_abbrv[8];      //!< Abbreviated weekday names
+    d_name_t month_names[13];       //!< Full month names (nominative, 12 is "Invalid")
+    d_name_t month_genitive[13];    //!< Full month names (genitive, e.g. "15 czerwca")
+    d_name_t month_abbrv[13];       //!< Abbreviated month names
+    d_name_t ampm_caps[2];          //!< AM/PM
+    d_name_t ampm_small[2];         //!< a.m./p.m.
+    d_name_t era[2];                //!< Era names (CE/BCE)
+} d_locale_t;
+
+//! \cond foo
+#define D_N(STR) {STR, sizeof(STR) - 1}
+#define D_WEEK(A, B, C, D, E, F, G) {D_N(A), D_N(B), D_N(C), D_N(D), D_N(E), D_N(F), D_N(G), D_N("Invalid")}
+#define D_WEEK_ABBRV(A, B, C, D, E, F, G) {D_N(A), D_N(B), D_N(C), D_N(D), D_N(E), D_N(F), D_N(G), D_N("Inv")}
+#define D_YEAR(A, B, C, D, E, F, G, H, I, J, K, L) {D_N(A), D_N(B), D_N(C), D_N(D), D_N(E), D_N(F), D_N(G), D_N(H), D_N(I), D_N(J), D_N(K), D_N(L), D_N("Invalid")}
+#define D_YEAR_ABBRV(A, B, C, D, E, F, G, H, I, J, K, L) {D_N(A), D_N(B), D_N(C), D_N(D), D_N(E), D_N(F), D_N(G), D_N(H), D_N(I), D_N(J), D_N(K), D_N(L), D_N("Inv")}
+#define D_PAIR(A, B) {D_N(A), D_N(B)}
+//! \endcond
+
+//! Built-in locales (all strings are UTF-8)
+const d_locale_t D_LOCALES[] = {
+    {"en",
+        D_WEEK("Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"),
+        D_WEEK_ABBRV("Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"),
+        D_YEAR("January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December"),
+        D_YEAR("January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December"),
+        D_YEAR_ABBRV("Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"),
+        D_PAIR("AM", "PM"), D_PAIR("a.m.", "p.m."), D_PAIR("CE", "BCE")},
+    {"pl",
+        D_WEEK("poniedziałek", "wtorek", "środa", "czwartek", "piątek", "sobota", "niedziela"),
+        D_WEEK_ABBRV("pon", "wt", "śr", "czw", "pt", "sob", "niedz"),
+        D_YEAR("styczeń", "luty", "marzec", "kwiecień", "maj", "czerwiec", "lipiec", "sierpień", "wrzesień", "październik", "listopad", "grudzień"),
+        D_YEAR("stycznia", "lutego", "marca", "kwietnia", "maja", "czerwca", "lipca", "sierpnia", "września", "października", "listopada", "grudnia"),
+        D_YEAR_ABBRV("sty", "lut", "mar", "kwi", "maj", "cze", "lip", "sie", "wrz", "paź", "lis", "gru"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("n.e.", "p.n.e.")},
+    {"de",
+        D_WEEK("Montag", "Dienstag", "Mittwoch", "Donnerstag", "Freitag", "Samstag", "Sonntag"),
+        D_WEEK_ABBRV("Mo", "Di", "Mi", "Do", "Fr", "Sa", "So"),
+        D_YEAR("Januar", "Februar", "März", "April", "Mai", "Juni", "Juli", "August", "September", "Oktober", "November", "Dezember"),
+        D_YEAR("Januar", "Februar", "März", "April", "Mai", "Juni", "Juli", "August", "September", "Oktober", "November", "Dezember"),
+        D_YEAR_ABBRV("Jan", "Feb", "Mär", "Apr", "Mai", "Jun", "Jul", "Aug", "Sep", "Okt", "Nov", "Dez"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("n. Chr.", "v. Chr.")},
+    {"fr",
+        D_WEEK("lundi", "mardi", "mercredi", "jeudi", "vendredi", "samedi", "dimanche"),
+        D_WEEK_ABBRV("lun.", "mar.", "mer.", "jeu.", "ven.", "sam.", "dim."),
+        D_YEAR("janvier", "février", "mars", "avril", "mai", "juin", "juillet", "août", "septembre", "octobre", "novembre", "décembre"),
+        D_YEAR("janvier", "février", "mars", "avril", "mai", "juin", "juillet", "août", "septembre", "octobre", "novembre", "décembre"),
+        D_YEAR_ABBRV("janv.", "févr.", "mars", "avr.", "mai", "juin", "juil.", "août", "sept.", "oct.", "nov.", "déc."),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("ap. J.-C.", "av. J.-C.")},
+    {"es",
+        D_WEEK("lunes", "martes", "miércoles", "jueves", "viernes", "sábado", "domingo"),
+        D_WEEK_ABBRV("lun", "mar", "mié", "jue", "vie", "sáb", "dom"),
+        D_YEAR("enero", "febrero", "marzo", "abril", "mayo", "junio", "julio", "agosto", "septiembre", "octubre", "noviembre", "diciembre"),
+        D_YEAR("enero", "febrero", "marzo", "abril", "mayo", "junio", "julio", "agosto", "septiembre", "octubre", "noviembre", "diciembre"),
+        D_YEAR_ABBRV("ene", "feb", "mar", "abr", "may", "jun", "jul", "ago", "sept", "oct", "nov", "dic"),
+        D_PAIR("A. M.", "P. M."), D_PAIR("a. m.", "p. m."), D_PAIR("d. C.", "a. C.")},
+    {"it",
+        D_WEEK("lunedì", "martedì", "mercoledì", "giovedì", "venerdì", "sabato", "domenica"),
+        D_WEEK_ABBRV("lun", "mar", "mer", "gio", "ven", "sab", "dom"),
+        D_YEAR("gennaio", "febbraio", "marzo", "aprile", "maggio", "giugno", "luglio", "agosto", "settembre", "ottobre", "novembre", "dicembre"),
+        D_YEAR("gennaio", "febbraio", "marzo", "aprile", "maggio", "giugno", "luglio", "agosto", "settembre", "ottobre", "novembre", "dicembre"),
+        D_YEAR_ABBRV("gen", "feb", "mar", "apr", "mag", "giu", "lug", "ago", "set", "ott", "nov", "dic"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("d.C.", "a.C.")},
+    {"pt",
+        D_WEEK("segunda-feira", "terça-feira", "quarta-feira", "quinta-feira", "sexta-feira", "sábado", "domingo"),
+        D_WEEK_ABBRV("seg", "ter", "qua", "qui", "sex", "sáb", "dom"),
+        D_YEAR("janeiro", "fevereiro", "março", "abril", "maio", "junho", "julho", "agosto", "setembro", "outubro", "novembro", "dezembro"),
+        D_YEAR("janeiro", "fevereiro", "março", "abril", "maio", "junho", "julho", "agosto", "setembro", "outubro", "novembro", "dezembro"),
+        D_YEAR_ABBRV("jan", "fev", "mar", "abr", "mai", "jun", "jul", "ago", "set", "out", "nov", "dez"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("d.C.", "a.C.")},
+    {"nl",
+        D_WEEK("maandag", "dinsdag", "woensdag", "donderdag", "vrijdag", "zaterdag", "zondag"),
+        D_WEEK_ABBRV("ma", "di", "wo", "do", "vr", "za", "zo"),
+        D_YEAR("januari", "februari", "maart", "april", "mei", "juni", "juli", "augustus", "september", "oktober", "november", "december"),
+        D_YEAR("januari", "februari", "maart", "april", "mei", "juni", "juli", "augustus", "september", "oktober", "november", "december"),
+        D_YEAR_ABBRV("jan", "feb", "mrt", "apr", "mei", "jun", "jul", "aug", "sep", "okt", "nov", "dec"),
+        D_PAIR("AM", "PM"), D_PAIR("a.m.", "p.m."), D_PAIR("n.Chr.", "v.Chr.")},
+    {"cs",
+        D_WEEK("pondělí", "úterý", "středa", "čtvrtek", "pátek", "sobota", "neděle"),
+        D_WEEK_ABBRV("po", "út", "st", "čt", "pá", "so", "ne"),
+        D_YEAR("leden", "únor", "březen", "duben", "květen", "červen", "červenec", "srpen", "září", "říjen", "listopad", "prosinec"),
+        D_YEAR("ledna", "února", "března", "dubna", "května", "června", "července", "srpna", "září", "října", "listopadu", "prosince"),
+        D_YEAR_ABBRV("led", "úno", "bře", "dub", "kvě", "čvn", "čvc", "srp", "zář", "říj", "lis", "pro"),
+        D_PAIR("DOP.", "ODP."), D_PAIR("dop.", "odp."), D_PAIR("n. l.", "př. n. l.")},
+    {"sv",
+        D_WEEK("måndag", "tisdag", "onsdag", "torsdag", "fredag", "lördag", "söndag"),
+        D_WEEK_ABBRV("mån", "tis", "ons", "tors", "fre", "lör", "sön"),
+        D_YEAR("januari", "februari", "mars", "april", "maj", "juni", "juli", "augusti", "september", "oktober", "november", "december"),
+        D_YEAR("januari", "februari", "mars", "april", "maj", "juni", "juli", "augusti", "september", "oktober", "november", "december"),
+        D_YEAR_ABBRV("jan", "feb", "mars", "apr", "maj", "juni", "juli", "aug", "sep", "okt", "nov", "dec"),
+        D_PAIR("FM", "EM"), D_PAIR("fm", "em"), D_PAIR("e.Kr.", "f.Kr.")},
+    {"ru",
+        D_WEEK("понедельник", "вторник", "среда", "четверг", "пятница", "суббота", "воскресенье"),
+        D_WEEK_ABBRV("пн", "вт", "ср", "чт", "пт", "сб", "вс"),
+        D_YEAR("январь", "февраль", "март", "апрель", "май", "июнь", "июль", "август", "сентябрь", "октябрь", "ноябрь", "декабрь"),
+        D_YEAR("января", "февраля", "марта", "апреля", "мая", "июня", "июля", "августа", "сентября", "октября", "ноября", "декабря"),
+        D_YEAR_ABBRV("янв", "фев", "мар", "апр", "май", "июн", "июл", "авг", "сен", "окт", "ноя", "дек"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("н. э.", "до н. э.")},
+    {"da",
+        D_WEEK("mandag", "tirsdag", "onsdag", "torsdag", "fredag", "lørdag", "søndag"),
+        D_WEEK_ABBRV("man", "tir", "ons", "tor", "fre", "lør", "søn"),
+        D_YEAR("januar", "februar", "marts", "april", "maj", "juni", "juli", "august", "september", "oktober", "november", "december"),
+        D_YEAR("januar", "februar", "marts", "april", "maj", "juni", "juli", "august", "september", "oktober", "november", "december"),
+        D_YEAR_ABBRV("jan", "feb", "mar", "apr", "maj", "jun", "jul", "aug", "sep", "okt", "nov", "dec"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("e.Kr.", "f.Kr.")},
+    {"nb",
+        D_WEEK("mandag", "tirsdag", "onsdag", "torsdag", "fredag", "lørdag", "søndag"),
+        D_WEEK_ABBRV("man", "tir", "ons", "tor", "fre", "lør", "søn"),
+        D_YEAR("januar", "februar", "mars", "april", "mai", "juni", "juli", "august", "september", "oktober", "november", "desember"),
+        D_YEAR("januar", "februar", "mars", "april", "mai", "juni", "juli", "august", "september", "oktober", "november", "desember"),
+        D_YEAR_ABBRV("jan", "feb", "mar", "apr", "mai", "jun", "jul", "aug", "sep", "okt", "nov", "des"),
+        D_PAIR("a.m.", "p.m."), D_PAIR("a.m.", "p.m."), D_PAIR("e.Kr.", "f.Kr.")},
+    {"fi",
+        D_WEEK("maanantai", "tiistai", "keskiviikko", "torstai", "perjantai", "lauantai", "sunnuntai"),
+        D_WEEK_ABBRV("ma", "ti", "ke", "to", "pe", "la", "su"),
+        D_YEAR("tammikuu", "helmikuu", "maaliskuu", "huhtikuu", "toukokuu", "kesäkuu", "heinäkuu", "elokuu", "syyskuu", "lokakuu", "marraskuu", "joulukuu"),
+        D_YEAR("tammikuuta", "helmikuuta", "maaliskuuta", "huhtikuuta", "toukokuuta", "kesäkuuta", "heinäkuuta", "elokuuta", "syyskuuta", "lokakuuta", "marraskuuta", "joulukuuta"),
+        D_YEAR_ABBRV("tammi", "helmi", "maalis", "huhti", "touko", "kesä", "heinä", "elo", "syys", "loka", "marras", "joulu"),
+        D_PAIR("ap.", "ip."), D_PAIR("ap.", "ip."), D_PAIR("jKr.", "eKr.")},
+    {"hu",
+        D_WEEK("hétfő", "kedd", "szerda", "csütörtök", "péntek", "szombat", "vasárnap"),
+        D_WEEK_ABBRV("H", "K", "Sze", "Cs", "P", "Szo", "V"),
+        D_YEAR("január", "február", "március", "április", "május", "június", "július", "augusztus", "szeptember", "október", "november", "december"),
+        D_YEAR("január", "február", "március", "április", "május", "június", "július", "augusztus", "szeptember", "október", "november", "december"),
+        D_YEAR_ABBRV("jan.", "febr.", "márc.", "ápr.", "máj.", "jún.", "júl.", "aug.", "szept.", "okt.", "nov.", "dec."),
+        D_PAIR("DE.", "DU."), D_PAIR("de.", "du."), D_PAIR("i. sz.", "i. e.")},
+    {"ro",
+        D_WEEK("luni", "marți", "miercuri", "joi", "vineri", "sâmbătă", "duminică"),
+        D_WEEK_ABBRV("lun", "mar", "mie", "joi", "vin", "sâm", "dum"),
+        D_YEAR("ianuarie", "februarie", "martie", "aprilie", "mai", "iunie", "iulie", "august", "septembrie", "octombrie", "noiembrie", "decembrie"),
+        D_YEAR("ianuarie", "februarie", "martie", "aprilie", "mai", "iunie", "iulie", "august", "septembrie", "octombrie", "noiembrie", "decembrie"),
+        D_YEAR_ABBRV("ian", "feb", "mar", "apr", "mai", "iun", "iul", "aug", "sept", "oct", "nov", "dec"),
+        D_PAIR("A.M.", "P.M."), D_PAIR("a.m.", "p.m."), D_PAIR("d.Hr.", "î.Hr.")},
+    {"sk",
+        D_WEEK("pondelok", "utorok", "streda", "štvrtok", "piatok", "sobota", "nedeľa"),
+        D_WEEK_ABBRV("po", "ut", "st", "št", "pi", "so", "ne"),
+        D_YEAR("január", "február", "marec", "apríl", "máj", "jún", "júl", "august", "september", "október", "november", "december"),
+        D_YEAR("januára", "februára", "marca", "apríla", "mája", "júna", "júla", "augusta", "septembra", "októbra", "novembra", "decembra"),
+        D_YEAR_ABBRV("jan", "feb", "mar", "apr", "máj", "jún", "júl", "aug", "sep", "okt", "nov", "dec"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("po Kr.", "pred Kr.")},
+    {"hr",
+        D_WEEK("ponedjeljak", "utorak", "srijeda", "četvrtak", "petak", "subota", "nedjelja"),
+        D_WEEK_ABBRV("pon", "uto", "sri", "čet", "pet", "sub", "ned"),
+        D_YEAR("siječanj", "veljača", "ožujak", "travanj", "svibanj", "lipanj", "srpanj", "kolovoz", "rujan", "listopad", "studeni", "prosinac"),
+        D_YEAR("siječnja", "veljače", "ožujka", "travnja", "svibnja", "lipnja", "srpnja", "kolovoza", "rujna", "listopada", "studenoga", "prosinca"),
+        D_YEAR_ABBRV("sij", "velj", "ožu", "tra", "svi", "lip", "srp", "kol", "ruj", "lis", "stu", "pro"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("po. Kr.", "pr. Kr.")},
+    {"sl",
+        D_WEEK("ponedeljek", "torek", "sreda", "četrtek", "petek", "sobota", "nedelja"),
+        D_WEEK_ABBRV("pon", "tor", "sre", "čet", "pet", "sob", "ned"),
+        D_YEAR("januar", "februar", "marec", "april", "maj", "junij", "julij", "avgust", "september", "oktober", "november", "december"),
+        D_YEAR("januar", "februar", "marec", "april", "maj", "junij", "julij", "avgust", "september", "oktober", "november", "december"),
+        D_YEAR_ABBRV("jan", "feb", "mar", "apr", "maj", "jun", "jul", "avg", "sep", "okt", "nov", "dec"),
+        D_PAIR("DOP.", "POP."), D_PAIR("dop.", "pop."), D_PAIR("po Kr.", "pr. Kr.")},
+    {"uk",
+        D_WEEK("понеділок", "вівторок", "середа", "четвер", "пʼятниця", "субота", "неділя"),
+        D_WEEK_ABBRV("пн", "вт", "ср", "чт", "пт", "сб", "нд"),
+        D_YEAR("січень", "лютий", "березень", "квітень", "травень", "червень", "липень", "серпень", "вересень", "жовтень", "листопад", "грудень"),
+        D_YEAR("січня", "лютого", "березня", "квітня", "травня", "червня", "липня", "серпня", "вересня", "жовтня", "листопада", "грудня"),
+        D_YEAR_ABBRV("січ", "лют", "бер", "кві", "тра", "чер", "лип", "сер", "вер", "жов", "лис", "гру"),
+        D_PAIR("ДП", "ПП"), D_PAIR("дп", "пп"), D_PAIR("н. е.", "до н. е.")},
+    {"el",
+        D_WEEK("Δευτέρα", "Τρίτη", "Τετάρτη", "Πέμπτη", "Παρασκευή", "Σάββατο", "Κυριακή"),
+        D_WEEK_ABBRV("Δευ", "Τρί", "Τετ", "Πέμ", "Παρ", "Σάβ", "Κυρ"),
+        D_YEAR("Ιανουάριος", "Φεβρουάριος", "Μάρτιος", "Απρίλιος", "Μάιος", "Ιούνιος", "Ιούλιος", "Αύγουστος", "Σεπτέμβριος", "Οκτώβριος", "Νοέμβριος", "Δεκέμβριος"),
+        D_YEAR("Ιανουαρίου", "Φεβρουαρίου", "Μαρτίου", "Απριλίου", "Μαΐου", "Ιουνίου", "Ιουλίου", "Αυγούστου", "Σεπτεμβρίου", "Οκτωβρίου", "Νοεμβρίου", "Δεκεμβρίου"),
+        D_YEAR_ABBRV("Ιαν", "Φεβ", "Μαρ", "Απρ", "Μαΐ", "Ιουν", "Ιουλ", "Αυγ", "Σεπ", "Οκτ", "Νοε", "Δεκ"),
+        D_PAIR("Π.Μ.", "Μ.Μ."), D_PAIR("π.μ.", "μ.μ."), D_PAIR("μ.Χ.", "π.Χ.")},
+    {"tr",
+        D_WEEK("Pazartesi", "Salı", "Çarşamba", "Perşembe", "Cuma", "Cumartesi", "Pazar"),
+        D_WEEK_ABBRV("Pzt", "Sal", "Çar", "Per", "Cum", "Cmt", "Paz"),
+        D_YEAR("Ocak", "Şubat", "Mart", "Nisan", "Mayıs", "Haziran", "Temmuz", "Ağustos", "Eylül", "Ekim", "Kasım", "Aralık"),
+        D_YEAR("Ocak", "Şubat", "Mart", "Nisan", "Mayıs", "Haziran", "Temmuz", "Ağustos", "Eylül", "Ekim", "Kasım", "Aralık"),
+        D_YEAR_ABBRV("Oca", "Şub", "Mar", "Nis", "May", "Haz", "Tem", "Ağu", "Eyl", "Eki", "Kas", "Ara"),
+        D_PAIR("ÖÖ", "ÖS"), D_PAIR("öö", "ös"), D_PAIR("MS", "MÖ")},
+    {"lt",
+        D_WEEK("pirmadienis", "antradienis", "trečiadienis", "ketvirtadienis", "penktadienis", "šeštadienis", "sekmadienis"),
+        D_WEEK_ABBRV("pr", "an", "tr", "kt", "pn", "št", "sk"),
+        D_YEAR("sausis", "vasaris", "kovas", "balandis", "gegužė", "birželis", "liepa", "rugpjūtis", "rugsėjis", "spalis", "lapkritis", "gruodis"),
+        D_YEAR("sausio", "vasario", "kovo", "balandžio", "gegužės", "birželio", "liepos", "rugpjūčio", "rugsėjo", "spalio", "lapkričio", "gruodžio"),
+        D_YEAR_ABBRV("saus.", "vas.", "kov.", "bal.", "geg.", "birž.", "liep.", "rugp.", "rugs.", "spal.", "lapkr.", "gruod."),
+        D_PAIR("PRIEŠPIET", "POPIET"), D_PAIR("priešpiet", "popiet"), D_PAIR("po Kr.", "pr. Kr.")},
+    {"lv",
+        D_WEEK("pirmdiena", "otrdiena", "trešdiena", "ceturtdiena", "piektdiena", "sestdiena", "svētdiena"),
+        D_WEEK_ABBRV("P", "O", "T", "C", "Pk", "S", "Sv"),
+        D_YEAR("janvāris", "februāris", "marts", "aprīlis", "maijs", "jūnijs", "jūlijs", "augusts", "septembris", "oktobris", "novembris", "decembris"),
+        D_YEAR("janvāris", "februāris", "marts", "aprīlis", "maijs", "jūnijs", "jūlijs", "augusts", "septembris", "oktobris", "novembris", "decembris"),
+        D_YEAR_ABBRV("janv.", "febr.", "marts", "apr.", "maijs", "jūn.", "jūl.", "aug.", "sept.", "okt.", "nov.", "dec."),
+        D_PAIR("PRIEKŠP.", "PĒCP."), D_PAIR("priekšp.", "pēcp."), D_PAIR("m.ē.", "p.m.ē.")},
+    {"et",
+        D_WEEK("esmaspäev", "teisipäev", "kolmapäev", "neljapäev", "reede", "laupäev", "pühapäev"),
+        D_WEEK_ABBRV("E", "T", "K", "N", "R", "L", "P"),
+        D_YEAR("jaanuar", "veebruar", "märts", "aprill", "mai", "juuni", "juuli", "august", "september", "oktoober", "november", "detsember"),
+        D_YEAR("jaanuar", "veebruar", "märts", "aprill", "mai", "juuni", "juuli", "august", "september", "oktoober", "november", "detsember"),
+        D_YEAR_ABBRV("jaan", "veebr", "märts", "apr", "mai", "juuni", "juuli", "aug", "sept", "okt", "nov", "dets"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("pKr", "eKr")},
+    {"ca",
+        D_WEEK("dilluns", "dimarts", "dimecres", "dijous", "divendres", "dissabte", "diumenge"),
+        D_WEEK_ABBRV("dl.", "dt.", "dc.", "dj.", "dv.", "ds.", "dg."),
+        D_YEAR("gener", "febrer", "març", "abril", "maig", "juny", "juliol", "agost", "setembre", "octubre", "novembre", "desembre"),
+        D_YEAR("gener", "febrer", "març", "abril", "maig", "juny", "juliol", "agost", "setembre", "octubre", "novembre", "desembre"),
+        D_YEAR_ABBRV("gen.", "febr.", "març", "abr.", "maig", "juny", "jul.", "ag.", "set.", "oct.", "nov.", "des."),
+        D_PAIR("A. M.", "P. M."), D_PAIR("a. m.", "p. m."), D_PAIR("dC", "aC")},
+    {"bg",
+        D_WEEK("понеделник", "вторник", "сряда", "четвъртък", "петък", "събота", "неделя"),
+        D_WEEK_ABBRV("пн", "вт", "ср", "чт", "пт", "сб", "нд"),
+        D_YEAR("януари", "февруари", "март", "април", "май", "юни", "юли", "август", "септември", "октомври", "ноември", "декември"),
+        D_YEAR("януари", "февруари", "март", "април", "май", "юни", "юли", "август", "септември", "октомври", "ноември", "декември"),
+        D_YEAR_ABBRV("яну", "фев", "март", "апр", "май", "юни", "юли", "авг", "сеп", "окт", "ное", "дек"),
+        D_PAIR("ПР.ОБ.", "СЛ.ОБ."), D_PAIR("пр.об.", "сл.об."), D_PAIR("сл.Хр.", "пр.Хр.")},
+    {"id",
+        D_WEEK("Senin", "Selasa", "Rabu", "Kamis", "Jumat", "Sabtu", "Minggu"),
+        D_WEEK_ABBRV("Sen", "Sel", "Rab", "Kam", "Jum", "Sab", "Min"),
+        D_YEAR("Januari", "Februari", "Maret", "April", "Mei", "Juni", "Juli", "Agustus", "September", "Oktober", "November", "Desember"),
+        D_YEAR("Januari", "Februari", "Maret", "April", "Mei", "Juni", "Juli", "Agustus", "September", "Oktober", "November", "Desember"),
+        D_YEAR_ABBRV("Jan", "Feb", "Mar", "Apr", "Mei", "Jun", "Jul", "Agu", "Sep", "Okt", "Nov", "Des"),
+        D_PAIR("AM", "PM"), D_PAIR("am", "pm"), D_PAIR("M", "SM")},
+    {"ms",
+        D_WEEK("Isnin", "Selasa", "Rabu", "Khamis", "Jumaat", "Sabtu", "Ahad"),
+        D_WEEK_ABBRV("Isn", "Sel", "Rab", "Kha", "Jum", "Sab", "Ahd"),
+        D_YEAR("Januari", "Februari", "Mac", "April", "Mei", "Jun", "Julai", "Ogos", "September", "Oktober", "November", "Disember"),
+        D_YEAR("Januari", "Februari", "Mac", "April", "Mei", "Jun", "Julai", "Ogos", "September", "Oktober", "November", "Disember"),
+        D_YEAR_ABBRV("Jan", "Feb", "Mac", "Apr", "Mei", "Jun", "Jul", "Ogo", "Sep", "Okt", "Nov", "Dis"),
+        D_PAIR("PG", "PTG"), D_PAIR("pg", "ptg"), D_PAIR("TM", "SM")},
+    {"vi",
+        D_WEEK("Thứ Hai", "Thứ Ba", "Thứ Tư", "Thứ Năm", "Thứ Sáu", "Thứ Bảy", "Chủ Nhật"),
+        D_WEEK_ABBRV("T2", "T3", "T4", "T5", "T6", "T7", "CN"),
+        D_YEAR("tháng 1", "tháng 2", "tháng 3", "tháng 4", "tháng 5", "tháng 6", "tháng 7", "tháng 8", "tháng 9", "tháng 10", "tháng 11", "tháng 12"),
+        D_YEAR("tháng 1", "tháng 2", "tháng 3", "tháng 4", "tháng 5", "tháng 6", "tháng 7", "tháng 8", "tháng 9", "tháng 10", "tháng 11", "tháng 12"),
+        D_YEAR_ABBRV("thg 1", "thg 2", "thg 3", "thg 4", "thg 5", "thg 6", "thg 7", "thg 8", "thg 9", "thg 10", "thg 11", "thg 12"),
+        D_PAIR("SA", "CH"), D_PAIR("sa", "ch"), D_PAIR("SCN", "TCN")},
+};
+
+//! \cond foo
+#undef D_PAIR
+#undef D_YEAR_ABBRV
+#undef D_YEAR
+#undef D_WEEK_ABBRV
+#undef D_WEEK
+#undef D_N
+//! \endcond
+
+//! Number of built-in locales
+#define D_LOCALE_COUNT (sizeof(D_LOCALES) / sizeof(D_LOCALES[0]))
+//! English locale (the one used by dnprintf)
+#define D_LOCALE_EN (&D_LOCALES[0])
+
+//! Index of a month (1..12) in the locale month tables; out of range months map to the "Invalid" entry
+#define D_MONTH_INDEX(M) ((unsigned)(M) - 1 < 12 ? (M) - 1 : 12)
+//! Index of a weekday (0..6) in the locale weekday tables; out of range weekdays map to the "Invalid" entry
+#define D_WEEKDAY_INDEX(W) ((unsigned)(W) < 7 ? (W) : 7)
+
+//! \brief Find a built-in locale by its language code
+//! \returns Pointer to the locale or NULL if there is no such locale
+const d_locale_t* d_locale_find(const char* code);
+//! \brief Match a name from a locale table at the beginning of a string
+//! \returns Index of the longest matching entry or -1 if no entry matches
+int d_locale_match(const d_name_t* names, int count, const char* str, size_t len, size_t* matched);
+//! \brief Match a month name (full, genitive or abbreviated) at the beginning of a string
+//! \returns Month (1..12) or 0 if no month name matches
+int d_locale_match_month(const d_locale_t* locale, const char* str, size_t len, size_t* matched);
+//! \brief Match a weekday name (full or abbreviated) at the beginning of a string
+//! \returns Weekday (0..6, where 0 is Monday) or -1 if no weekday name matches
+int d_locale_match_weekday(const d_locale_t* locale, const char* str, size_t len, size_t* matched);
+
+const d_locale_t* d_locale_find(const char* code)
+{
+    for (size_t i = 0; i < D_LOCALE_COUNT; i++)
+    {
+        if (strcmp(D_LOCALES[i].code, code) == 0) return &D_LOCALES[i];
+    }
+    return NULL;
+}
+
+/*!
+    Comparison is case insensitive for ASCII letters only, other bytes have to match exactly.
+    \param names name table
+    \param count number of entries in the table
+    \param str string to match
+    \param len length of the string
+    \param matched if not NULL, length of the matched entry is stored there
+*/
+int d_locale_match(const d_name_t* names, int count, const char* str, size_t len, size_t* matched)
+{
+    int best = -1;
+    size_t best_len = 0;
+    for (int i = 0; i < count; i++)
+    {
+        size_t n = names[i].len;
+        if (n <= best_len || n > len) continue;
+        size_t k = 0;
+        while (k < n && tolower((unsigned char)str[k]) == tolower((unsigned char)names[i].str[k])) k++;
+        if (k == n)
+        {
+            best = i;
+            best_len = n;
+        }
+    }
+    if (matched != NULL) *matched = best_len;
+    return best;
+}
+
+int d_locale_match_month(const d_locale_t* locale, const char* str, size_t len, size_t* matched)
+{
+    const d_name_t* tables[] = {locale->month_names, locale->month_genitive, locale->month_abbrv};
+    int month = 0;
+    size_t best_len = 0;
+    for (int t = 0; t < 3; t++)
+    {
+        size_t n;
+        int i = d_locale_match(tables[t], 12, str, len, &n);
+        if (i >= 0 && n > best_len)
+        {
+            month = i + 1;
+            best_len = n;
+        }
+    }
+    if (matched != NULL) *matched = best_len;
+    return month;
+}
+
+int d_locale_match_weekday(const d_locale_t* locale, const char* str, size_t len, size_t* matched)
+{
+    size_t full_len, abbrv_len;
+    int full = d_locale_match(locale->weekday_names, 7, str, len, &full_len);
+    int abbrv = d_locale_match(locale->weekday_abbrv, 7, str, len, &abbrv_len);
+    if (matched != NULL) *matched = (full_len >= abbrv_len ? full_len : abbrv_len);
+    return (full_len >= abbrv_len ? full : abbrv);
+}
@@ -0,0 +1,192 @@
+/*! \file
+    \brief Optional instrumentation of the library's hot paths
+
+    Counting is enabled by compiling with `-DDATELIB_PROFILE`; cycle timing of the instrumented
+    functions additionally requires `-DDATELIB_PROFILE_CYCLES`. Without these flags all the D_PROF_*
+    macros expand to nothing, and the functions below only ever report zeros.
+
+    Counters are accumulated in thread-local storage without any synchronisation. A thread publishes
+    its counters to the process-wide totals with d_prof_flush() (e.g. before it exits), and
+    d_prof_snapshot() returns the totals together with the calling thread's unflushed counters.
+
+    Timed functions record self time: cycles spent in a timed function called from another one (e.g.
+    iso_week_number called by dnprintf) are subtracted from the caller, so the cycles of all counters
+    add up to the time actually spent in the library.
+*/
+
+//! Instrumentation counters
+typedef enum
+{
+    D_PROF_TIME_TO_DATE,                //!< time_to_date calls
+    D_PROF_TIME_TO_DATE_YEAR_STEP,      //!< Iterations of the year loop in time_to_date
+    D_PROF_TIME_TO_DATE_MONTH_STEP,     //!< Iterations of the month loop in time_to_date
+    D_PROF_DATE_TO_TIME,                //!< date_to_time calls
+    D_PROF_DATE_TO_TIME_MONTH_STEP,     //!< Iterations of the month loop in date_to_time
+    D_PROF_DATE_TO_USEC,                //!< date_to_usec_since_zero calls
+    D_PROF_USEC_TO_DATE,                //!< usec_since_zero_to_date calls
+    D_PROF_FIX_DATE,                    //!< fix_date calls
+    D_PROF_ISO_WEEK_NUMBER,             //!< iso_week_number calls
+    D_PROF_CURRENT_TIME_FALLBACK,       //!< get_current_time falling back to localtime for the time zone
+    D_PROF_DNPRINTF,                    //!< dnprintf/dnprintf_l calls
+    D_PROF_PLACE_N_STRDUP,              //!< place_n_in_s calls building a format with strdup
+    D_PROF_PLACE_S_STRDUP,              //!< place_s_in_s calls building a format with strdup
+    D_PROF_ROMAN,                       //!< convert_to_roman calls
+    D_PROF_COUNT
+} d_prof_counter_t;
+
+//! Counter names, as printed by d_prof_report
+const char* D_PROF_NAMES[] = {
+    "time_to_date", "time_to_date/year_step", "time_to_date/month_step",
+    "date_to_time", "date_to_time/month_step",
+    "date_to_usec_since_zero", "usec_since_zero_to_date",
+    "fix_date", "iso_week_number",
+    "get_current_time/fallback",
+    "dnprintf", "place_n_in_s/strdup", "place_s_in_s/strdup", "convert_to_roman"
+};
+
+//! Counter values
+typedef struct
+{
+    unsigned long long hits[D_PROF_COUNT];      //!< Number of calls or slow path hits
+    unsigned long long cycles[D_PROF_COUNT];    //!< Self time spent in the function, excluding timed callees (only for timed functions)
+} d_prof_snapshot_t;
+
+//! Add the calling thread's counters to the process-wide totals and reset them
+void d_prof_flush();
+//! Get the process-wide totals together with the calling thread's unflushed counters
+void d_prof_snapshot(d_prof_snapshot_t* snapshot);
+//! Reset the process-wide totals and the calling thread's counters
+void d_prof_reset();
+//! Print a snapshot as a table (shares are of the total self time)
+void d_prof_report(FILE* file, const d_prof_snapshot_t* snapshot);
+
+#ifdef DATELIB_PROFILE
+
+#ifdef __cplusplus
+#define D_THREAD_LOCAL thread_local
+#else
+#define D_THREAD_LOCAL _Thread_local
+#endif
+
+D_THREAD_LOCAL d_prof_snapshot_t _d_prof_local;
+d_prof_snapshot_t _d_prof_total;
+
+//! \cond foo
+#define D_PROF_HIT(ID) (_d_prof_local.hits[ID]++)
+//! \endcond
+
+#ifdef DATELIB_PROFILE_CYCLES
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+//! Cycle counter used for timing
+unsigned long long _d_prof_clock() { return __rdtsc(); }
+#else
+//! Cycle counter used for timing (nanoseconds where there is no cycle counter)
+unsigned long long _d_prof_clock()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+//! Cycles spent in timed callees of the innermost running timed function of this thread
+D_THREAD_LOCAL unsigned long long _d_prof_children;
+
+//! Start timing a function, returning the children time of the enclosing timed function
+unsigned long long _d_prof_enter()
+{
+    unsigned long long outer = _d_prof_children;
+    _d_prof_children = 0;
+    return outer;
+}
+
+//! Stop timing a function: record its self time and add its whole time to the enclosing function's children
+void _d_prof_leave(d_prof_counter_t id, unsigned long long start, unsigned long long outer)
+{
+    unsigned long long elapsed = _d_prof_clock() - start;
+    _d_prof_local.cycles[id] += elapsed - _d_prof_children;
+    _d_prof_children = outer + elapsed;
+}
+
+//! \cond foo
+#define D_PROF_BEGIN(ID) D_PROF_HIT(ID); unsigned long long _d_prof_outer_##ID = _d_prof_enter(); \
+    unsigned long long _d_prof_start_##ID = _d_prof_clock()
+#define D_PROF_END(ID) _d_prof_leave(ID, _d_prof_start_##ID, _d_prof_outer_##ID)
+//! \endcond
+
+#else
+
+//! \cond foo
+#define D_PROF_BEGIN(ID) D_PROF_HIT(ID)
+#define D_PROF_END(ID) ((void)0)
+//! \endcond
+
+#endif
+
+void d_prof_flush()
+{
+    for (int i = 0; i < D_PROF_COUNT; i++)
+    {
+        __atomic_fetch_add(&_d_prof_total.hits[i], _d_prof_local.hits[i], __ATOMIC_RELAXED);
+        __atomic_fetch_add(&_d_prof_total.cycles[i], _d_prof_local.cycles[i], __ATOMIC_RELAXED);
+    }
+    memset(&_d_prof_local, 0, sizeof(_d_prof_local));
+}
+
+void d_prof_snapshot(d_prof_snapshot_t* snapshot)
+{
+    for (int i = 0; i < D_PROF_COUNT; i++)
+    {
+        snapshot->hits[i] = __atomic_load_n(&_d_prof_total.hits[i], __ATOMIC_RELAXED) + _d_prof_local.hits[i];
+        snapshot->cycles[i] = __atomic_load_n(&_d_prof_total.cycles[i], __ATOMIC_RELAXED) + _d_prof_local.cycles[i];
+    }
+}
+
+void d_prof_reset()
+{
+    for (int i = 0; i < D_PROF_COUNT; i++)
+    {
+        __atomic_store_n(&_d_prof_total.hits[i], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&_d_prof_total.cycles[i], 0, __ATOMIC_RELAXED);
+    }
+    memset(&_d_prof_local, 0, sizeof(_d_prof_local));
+}
+
+#else
+
+//! \cond foo
+#define D_PROF_HIT(ID) ((void)0)
+#define D_PROF_BEGIN(ID) ((void)0)
+#define D_PROF_END(ID) ((void)0)
+//! \endcond
+
+void d_prof_flush() {}
+
+void d_prof_snapshot(d_prof_snapshot_t* snapshot)
+{
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+void d_prof_reset() {}
+
+#endif
+
+void d_prof_report(FILE* file, const d_prof_snapshot_t* snapshot)
+{
+    unsigned long long total = 0;
+    for (int i = 0; i < D_PROF_COUNT; i++) total += snapshot->cycles[i];
+
+    fprintf(file, "%-36s %14s %16s %10s %7s\n", "counter", "hits", "cycles", "per hit", "share");
+    for (int i = 0; i < D_PROF_COUNT; i++)
+    {
+        fprintf(file, "%-36s %14llu", D_PROF_NAMES[i], snapshot->hits[i]);
+        if (snapshot->cycles[i] != 0)
+        {
+            fprintf(file, " %16llu %10.1f %6.1f%%", snapshot->cycles[i],
+                (double)snapshot->cycles[i] / snapshot->hits[i], 100.0 * snapshot->cycles[i] / total);
+        }
+        fprintf(file, "\n");
+    }
+}
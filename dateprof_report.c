@@ -0,0 +1,46 @@
+// Runs typical conversion and formatting workloads and reports where the time goes.
+// Build with: cc -O2 -DDATELIB_PROFILE -DDATELIB_PROFILE_CYCLES dateprof_report.c -o dateprof_report -lm -pthread
+
+#include "datecal.h"
+#include "dateformat.h"
+#include <pthread.h>
+
+#define THREADS 4
+
+const char* formats[] = {F_ISO_8601_T, F_RFC_2822, F_ISO_8601_WDATE, F_US_LONGER, "%d %r %R %L"};
+
+void* workload(void* arg)
+{
+    long iterations = *(long*)arg;
+    char buffer[100];
+    volatile time_t sink = 0;
+
+    for (long i = 0; i < iterations; i++)
+    {
+        // Spread the dates over 1900..2100
+        time_t t = -2208988800L + (i * 7919L % 73000L) * 86400L + i % 86400L;
+        date_t d = time_to_date(t);
+        sink += date_to_time(d);
+        convert_to_timezone(&d, 60);
+        dnprintf(d, buffer, sizeof(buffer), formats[i % (sizeof(formats) / sizeof(formats[0]))]);
+    }
+
+    d_prof_flush();
+    return NULL;
+}
+
+int main(int argc, char** argv)
+{
+    long iterations = (argc > 1 ? atol(argv[1]) : 100000);
+    pthread_t threads[THREADS];
+
+    for (int i = 0; i < THREADS; i++) pthread_create(&threads[i], NULL, workload, &iterations);
+    for (int i = 0; i < THREADS; i++) pthread_join(threads[i], NULL);
+
+    d_prof_snapshot_t snapshot;
+    d_prof_snapshot(&snapshot);
+    printf("%d threads, %ld iterations each\n\n", THREADS, iterations);
+    d_prof_report(stdout, &snapshot);
+
+    return 0;
+}
@@ -0,0 +1,334 @@
+/*! \file
+    \brief Hierarchical timer wheel for callbacks at calendar times
+
+    Timers are keyed on instants in microseconds since 0000-01-01 00:00 UTC (see
+    date_to_usec_since_zero). The wheel has TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS slots;
+    a timer is put into the level that covers its distance from the current tick, and moved to
+    lower levels ("cascaded") as the wheel turns. Scheduling and cancelling are O(1), and advancing
+    jumps straight to the next tick at which a slot of any level has to be fired or cascaded.
+
+    A wheel is owned by one thread, which advances it and may schedule and cancel timers directly.
+    Other threads can only schedule with timer_wheel_schedule_concurrent, which pushes the timer
+    onto a lock-free stack drained by the owner on its next advance.
+*/
+
+//! \cond foo
+#define TIMER_WHEEL_BITS 6
+//! \endcond
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)   //!< Number of slots in a level
+#define TIMER_WHEEL_LEVELS 6                        //!< Number of levels
+//! Largest distance of a timer from the current tick (further timers wait in the last slot)
+#define TIMER_WHEEL_MAX_TICKS ((1LL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1)
+
+typedef struct date_timer date_timer_t;
+typedef struct timer_wheel timer_wheel_t;
+//! Callback of a timer; it may schedule or cancel any timer, including itself
+typedef void (*timer_callback_t)(timer_wheel_t* wheel, date_timer_t* timer, void* arg);
+
+//! \cond foo
+enum { TIMER_IDLE, TIMER_PENDING, TIMER_SCHEDULED, TIMER_CANCELLED, TIMER_FIRING };
+//! \endcond
+
+//! Timer; owned by the caller, it has to stay alive while scheduled
+struct date_timer
+{
+    long long expires;          //!< Instant at which the timer fires
+    timer_callback_t callback;
+    void* arg;
+    date_timer_t* next;         //!< Next timer in the slot, or in the stack of concurrently scheduled timers
+    date_timer_t** pprev;       //!< Pointer to the pointer to this timer in its slot
+    date_timer_t* fire_next;    //!< Next timer in the batch of expired timers being fired
+    date_timer_t** fire_pprev;  //!< Pointer to the pointer to this timer in the batch
+    int state;
+    int slot;                   //!< Level * TIMER_WHEEL_SLOTS + index of the slot
+    // Recurrence of timers scheduled with timer_wheel_schedule_daily
+    const time_zone_t* zone;
+    int minute_of_day;          //!< Local time of day in minutes, or -1 for one-shot timers
+    int weekdays;               //!< Weekday mask (bit 0 is Monday)
+};
+
+//! Timer wheel
+struct timer_wheel
+{
+    long long resolution;       //!< Length of a tick in microseconds
+    long long tick;             //!< Next tick to be processed
+    size_t count;               //!< Number of timers in the slots
+    date_timer_t* slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    unsigned long long occupied[TIMER_WHEEL_LEVELS];    //!< Bit masks of non-empty slots
+    date_timer_t* incoming;     //!< Stack of timers scheduled by timer_wheel_schedule_concurrent
+    date_timer_t* firing;       //!< Expired timers whose callbacks have not run yet
+};
+
+//! Initialize a timer
+void timer_init(date_timer_t* timer, timer_callback_t callback, void* arg);
+//! Initialize a wheel at an instant, with a tick length in microseconds
+void timer_wheel_init(timer_wheel_t* wheel, long long now, long long resolution);
+//! \brief Schedule (or reschedule) a one-shot timer at an instant, in O(1)
+//! \details Timers in the past fire on the next advance.
+void timer_wheel_schedule(timer_wheel_t* wheel, date_timer_t* timer, long long expires);
+//! \brief Schedule an idle one-shot timer from any thread, without locks
+//! \details The timer is added to the wheel on the owner's next advance; other threads cannot
+//! schedule it again before that, but the owner can cancel or reschedule it.
+void timer_wheel_schedule_concurrent(timer_wheel_t* wheel, date_timer_t* timer, long long expires);
+/*! \brief Schedule a timer which fires every day (on selected weekdays) at a local time in a time zone
+    \details After each run, the timer is rescheduled to the next such local time, so that it
+    follows changes of the time zone's offset. If the wheel is advanced past several such times
+    at once (e.g. after the clock jumped), the timer runs once and resumes after the current time.
+    \returns false (and leaves the timer alone) if weekdays is empty
+*/
+bool timer_wheel_schedule_daily(timer_wheel_t* wheel, date_timer_t* timer, const time_zone_t* zone, int minute_of_day, int weekdays);
+//! Cancel a timer in O(1), also if it has expired but its callback has not run yet (does nothing if it is not scheduled)
+void timer_wheel_cancel(timer_wheel_t* wheel, date_timer_t* timer);
+//! \brief Run callbacks of all the timers which expire up to an instant
+//! \returns Number of callbacks run
+size_t timer_wheel_advance(timer_wheel_t* wheel, long long now);
+//! Current time in microseconds since 0000-01-01 00:00 UTC, the default clock of timer_wheel_run
+long long timer_clock_current_time();
+//! \brief Advance a wheel with a clock every tick until *stop is set
+//! \param clock clock returning microseconds since 0000-01-01 00:00 UTC, or NULL for timer_clock_current_time
+void timer_wheel_run(timer_wheel_t* wheel, long long (*clock)(), volatile bool* stop);
+
+void timer_init(date_timer_t* timer, timer_callback_t callback, void* arg)
+{
+    memset(timer, 0, sizeof(*timer));
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->state = TIMER_IDLE;
+    timer->minute_of_day = -1;
+}
+
+void timer_wheel_init(timer_wheel_t* wheel, long long now, long long resolution)
+{
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->resolution = resolution;
+    wheel->tick = _divl(now, resolution);
+}
+
+//! Put a timer into the slot for its distance from the current tick
+void _timer_wheel_insert(timer_wheel_t* wheel, date_timer_t* timer)
+{
+    // Round up, so that timers never fire before they expire
+    long long tick = _divl(timer->expires + wheel->resolution - 1, wheel->resolution);
+    long long delta = tick - wheel->tick;
+    if (delta < 0) tick = wheel->tick;
+    else if (delta > TIMER_WHEEL_MAX_TICKS) tick = wheel->tick + TIMER_WHEEL_MAX_TICKS;
+    delta = tick - wheel->tick;
+
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1LL << (TIMER_WHEEL_BITS * (level + 1)))) level++;
+    int index = (tick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+    date_timer_t** slot = &wheel->slots[level][index];
+    timer->slot = level * TIMER_WHEEL_SLOTS + index;
+    wheel->occupied[level] |= 1ULL << index;
+
+    timer->next = *slot;
+    if (*slot != NULL) (*slot)->pprev = &timer->next;
+    timer->pprev = slot;
+    *slot = timer;
+    timer->state = TIMER_SCHEDULED;
+    wheel->count++;
+}
+
+//! Take a timer out of its slot
+void _timer_wheel_unlink(timer_wheel_t* wheel, date_timer_t* timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next != NULL) timer->next->pprev = timer->pprev;
+    int level = timer->slot / TIMER_WHEEL_SLOTS, index = timer->slot % TIMER_WHEEL_SLOTS;
+    if (wheel->slots[level][index] == NULL) wheel->occupied[level] &= ~(1ULL << index);
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->state = TIMER_IDLE;
+    wheel->count--;
+}
+
+//! Take an expired timer out of the batch being fired
+void _timer_wheel_unlink_firing(timer_wheel_t* wheel, date_timer_t* timer)
+{
+    *timer->fire_pprev = timer->fire_next;
+    if (timer->fire_next != NULL) timer->fire_next->fire_pprev = timer->fire_pprev;
+    timer->fire_next = NULL;
+    timer->fire_pprev = NULL;
+    timer->state = TIMER_IDLE;
+}
+
+void timer_wheel_schedule(timer_wheel_t* wheel, date_timer_t* timer, long long expires)
+{
+    int state = __atomic_load_n(&timer->state, __ATOMIC_ACQUIRE);
+    if (state == TIMER_SCHEDULED) _timer_wheel_unlink(wheel, timer);
+    else if (state == TIMER_FIRING) _timer_wheel_unlink_firing(wheel, timer);
+    timer->expires = expires;
+    timer->minute_of_day = -1;
+    // A timer still in the stack of concurrently scheduled timers is inserted by the next advance
+    if (state == TIMER_PENDING || state == TIMER_CANCELLED) __atomic_store_n(&timer->state, TIMER_PENDING, __ATOMIC_RELAXED);
+    else _timer_wheel_insert(wheel, timer);
+}
+
+void timer_wheel_schedule_concurrent(timer_wheel_t* wheel, date_timer_t* timer, long long expires)
+{
+    timer->expires = expires;
+    timer->minute_of_day = -1;
+    __atomic_store_n(&timer->state, TIMER_PENDING, __ATOMIC_RELAXED);
+    date_timer_t* head = __atomic_load_n(&wheel->incoming, __ATOMIC_RELAXED);
+    do
+    {
+        timer->next = head;
+    } while (!__atomic_compare_exchange_n(&wheel->incoming, &head, timer, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+bool timer_wheel_schedule_daily(timer_wheel_t* wheel, date_timer_t* timer, const time_zone_t* zone, int minute_of_day, int weekdays)
+{
+    if ((weekdays & D_EVERY_DAY) == 0) return false;
+    long long now = wheel->tick * wheel->resolution;
+    timer_wheel_schedule(wheel, timer, zone_next_local_time(zone, now, minute_of_day, weekdays));
+    timer->zone = zone;
+    timer->minute_of_day = minute_of_day;
+    timer->weekdays = weekdays;
+    return true;
+}
+
+void timer_wheel_cancel(timer_wheel_t* wheel, date_timer_t* timer)
+{
+    int state = __atomic_load_n(&timer->state, __ATOMIC_ACQUIRE);
+    if (state == TIMER_SCHEDULED) _timer_wheel_unlink(wheel, timer);
+    else if (state == TIMER_FIRING) _timer_wheel_unlink_firing(wheel, timer);
+    else if (state == TIMER_PENDING) __atomic_store_n(&timer->state, TIMER_CANCELLED, __ATOMIC_RELAXED);
+    timer->minute_of_day = -1;
+}
+
+//! Move the timers of a slot to lower levels
+//! \returns Index of the slot
+int _timer_wheel_cascade(timer_wheel_t* wheel, int level)
+{
+    int index = (wheel->tick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+    date_timer_t* timer = wheel->slots[level][index];
+    wheel->slots[level][index] = NULL;
+    wheel->occupied[level] &= ~(1ULL << index);
+    while (timer != NULL)
+    {
+        date_timer_t* next = timer->next;
+        wheel->count--;
+        _timer_wheel_insert(wheel, timer);
+        timer = next;
+    }
+    return index;
+}
+
+//! Next tick (from the current one on) at which a level 0 slot fires or a slot of a higher level is cascaded
+long long _timer_wheel_next_event(const timer_wheel_t* wheel)
+{
+    long long next = wheel->tick + TIMER_WHEEL_MAX_TICKS + 1;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        if (wheel->occupied[level] == 0) continue;
+        // Level 0 slots fire from the current tick on; slots of higher levels were cascaded when
+        // their period started, so the current one holds timers a full revolution ahead
+        long long base = wheel->tick >> (TIMER_WHEEL_BITS * level);
+        int first = (level > 0);
+        int shift = (base + first) & (TIMER_WHEEL_SLOTS - 1);
+        unsigned long long mask = wheel->occupied[level];
+        unsigned long long ahead = (shift == 0 ? mask : (mask >> shift) | (mask << (TIMER_WHEEL_SLOTS - shift)));
+        long long tick = (base + first + __builtin_ctzll(ahead)) << (TIMER_WHEEL_BITS * level);
+        if (tick < next) next = tick;
+        // Higher levels cascade at the end of the current level 0 period at the earliest
+        if (next <= (wheel->tick | (TIMER_WHEEL_SLOTS - 1))) break;
+    }
+    return next;
+}
+
+size_t timer_wheel_advance(timer_wheel_t* wheel, long long now)
+{
+    // Add the timers scheduled by other threads
+    date_timer_t* incoming = __atomic_exchange_n(&wheel->incoming, NULL, __ATOMIC_ACQUIRE);
+    while (incoming != NULL)
+    {
+        date_timer_t* next = incoming->next;
+        if (incoming->state == TIMER_CANCELLED) incoming->state = TIMER_IDLE;
+        else _timer_wheel_insert(wheel, incoming);
+        incoming = next;
+    }
+
+    // Collect the expired timers first, so that callbacks can schedule and cancel timers freely
+    long long target = _divl(now, wheel->resolution);
+    date_timer_t** last = &wheel->firing;
+    while (*last != NULL) last = &(*last)->fire_next;
+    while (wheel->tick <= target)
+    {
+        if (wheel->count == 0)
+        {
+            wheel->tick = target + 1;
+            break;
+        }
+
+        int index = wheel->tick & (TIMER_WHEEL_SLOTS - 1);
+        for (int level = 1; index == 0 && level < TIMER_WHEEL_LEVELS; level++) index = _timer_wheel_cascade(wheel, level);
+
+        // Skip the ticks at which no slot fires or cascades
+        long long next = _timer_wheel_next_event(wheel);
+        if (next != wheel->tick)
+        {
+            wheel->tick = (next <= target ? next : target + 1);
+            continue;
+        }
+
+        // Move the slot's timers to the end of the batch, in the order of their ticks
+        index = wheel->tick & (TIMER_WHEEL_SLOTS - 1);
+        date_timer_t* timer = wheel->slots[0][index];
+        wheel->slots[0][index] = NULL;
+        wheel->occupied[0] &= ~(1ULL << index);
+        while (timer != NULL)
+        {
+            date_timer_t* next_in_slot = timer->next;
+            timer->next = NULL;
+            timer->pprev = NULL;
+            timer->state = TIMER_FIRING;
+            timer->fire_next = NULL;
+            timer->fire_pprev = last;
+            *last = timer;
+            last = &timer->fire_next;
+            wheel->count--;
+            timer = next_in_slot;
+        }
+        wheel->tick++;
+    }
+
+    // Callbacks may cancel or reschedule timers of the batch, which takes them out of it
+    size_t fired = 0;
+    while (wheel->firing != NULL)
+    {
+        date_timer_t* timer = wheel->firing;
+        _timer_wheel_unlink_firing(wheel, timer);
+
+        // Re-arm recurring timers before the callback, so that it can cancel them. Runs missed
+        // while the wheel was not advanced are skipped rather than fired back to back.
+        if (timer->minute_of_day >= 0)
+        {
+            long long after = (timer->expires > now ? timer->expires : now);
+            long long expires = zone_next_local_time(timer->zone, after, timer->minute_of_day, timer->weekdays);
+            if (expires > after)
+            {
+                timer->expires = expires;
+                _timer_wheel_insert(wheel, timer);
+            }
+        }
+        timer->callback(wheel, timer, timer->arg);
+        fired++;
+    }
+    return fired;
+}
+
+long long timer_clock_current_time()
+{
+    return date_to_usec_since_zero(get_current_time());
+}
+
+void timer_wheel_run(timer_wheel_t* wheel, long long (*clock)(), volatile bool* stop)
+{
+    if (clock == NULL) clock = timer_clock_current_time;
+    struct timespec tick = {(time_t)(wheel->resolution / 1000000), (long)(wheel->resolution % 1000000) * 1000};
+    while (!*stop)
+    {
+        timer_wheel_advance(wheel, clock());
+        nanosleep(&tick, NULL);
+    }
+}
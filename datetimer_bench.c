@@ -0,0 +1,96 @@
+// Load benchmark of the timer wheel: schedules, cancels and expires a million timers.
+// Build with: cc -O2 datetimer_bench.c -o datetimer_bench -lm -pthread
+
+#include "datecal.h"
+#include "datetimer.h"
+#include <pthread.h>
+
+#define TIMERS 1000000
+#define THREADS 4
+#define HOUR 3600000000LL
+
+date_timer_t timers[TIMERS];
+long long expiries[TIMERS];
+size_t callbacks = 0;
+timer_wheel_t wheel;
+
+void callback(timer_wheel_t* wheel, date_timer_t* timer, void* arg)
+{
+    callbacks++;
+}
+
+double seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//! Print time taken since start, per operation (scheduled, cancelled or fired timer)
+void report(const char* what, double start, size_t ops)
+{
+    double elapsed = seconds() - start;
+    printf("%-40s %8.3f s %8.1f ns/op\n", what, elapsed, elapsed * 1e9 / ops);
+}
+
+void* producer(void* arg)
+{
+    size_t first = (size_t)arg;
+    for (size_t i = first; i < TIMERS; i += THREADS) timer_wheel_schedule_concurrent(&wheel, &timers[i], expiries[i]);
+    return NULL;
+}
+
+//! Advance a wheel from start to end in steps, as a driver loop would
+size_t run(long long start, long long end, long long step)
+{
+    size_t fired = 0;
+    for (long long now = start; now <= end; now += step) fired += timer_wheel_advance(&wheel, now);
+    return fired;
+}
+
+int main(int argc, char** argv)
+{
+    long long start = date_to_usec_since_zero(make_date(2027, 1, 1, 0, 0, 0, 0, 0));
+    srand(1);
+    for (size_t i = 0; i < TIMERS; i++)
+    {
+        // Most timers within an hour, some within a week
+        long long range = (i % 16 == 1 ? 168 * HOUR : HOUR);
+        expiries[i] = start + (((long long)rand() << 20) ^ rand()) % range;
+        timer_init(&timers[i], callback, NULL);
+    }
+
+    printf("%d timers, 1 ms ticks\n\n", TIMERS);
+
+    timer_wheel_init(&wheel, start, 1000);
+    double t = seconds();
+    for (size_t i = 0; i < TIMERS; i++) timer_wheel_schedule(&wheel, &timers[i], expiries[i]);
+    report("schedule", t, TIMERS);
+
+    t = seconds();
+    for (size_t i = 0; i < TIMERS; i += 2) timer_wheel_cancel(&wheel, &timers[i]);
+    report("cancel every other timer", t, TIMERS / 2);
+
+    t = seconds();
+    size_t fired = run(start, start + HOUR, 1000);
+    report("advance an hour in 1 ms steps", t, fired);
+    t = seconds();
+    fired = run(start + HOUR, start + 168 * HOUR, 1000000);
+    report("advance the rest of a week in 1 s steps", t, fired);
+    printf("  %zu callbacks, %zu timers left\n", callbacks, wheel.count);
+
+    timer_wheel_init(&wheel, start, 1000);
+    pthread_t threads[THREADS];
+    t = seconds();
+    for (size_t i = 0; i < THREADS; i++) pthread_create(&threads[i], NULL, producer, (void*)i);
+    for (size_t i = 0; i < THREADS; i++) pthread_join(threads[i], NULL);
+    report("schedule concurrently (4 threads)", t, TIMERS);
+
+    t = seconds();
+    callbacks = 0;
+    fired = run(start, start + 168 * HOUR, 100000);
+    report("advance a week in 100 ms steps", t, fired);
+    printf("  %zu callbacks, %zu timers left\n", callbacks, wheel.count);
+
+    return 0;
+}
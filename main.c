@@ -1,5 +1,6 @@
 #include "datecal.h"
 #include "dateformat.h"
+#include "dateinterval.h"
 #include <time.h>
 
 #define TEST(DATE, STR) dnprintf(DATE, buffer, 100, STR); \
@@ -55,6 +56,51 @@ int main(int argc, char** argv)
     easter_in_year(&pearl_harbor);
     TEST(pearl_harbor, "Easter that year: %d.%0m.%J %L");
     
+    printf("\n============= Locales ==============\n");
+    
+    // Unknown codes ("xx") fall back to English
+    const char* codes[] = {"pl", "de", "fr", "cs", "ru", "xx"};
+    for (int i = 0; i < sizeof(codes) / sizeof(codes[0]); i++)
+    {
+        dnprintf_l(caesars_assasitation, buffer, 100, "%B, %d %G %J %L", d_locale_find(codes[i]));
+        printf(" - %s: %s\n", codes[i], buffer);
+    }
+    
+    printf("\n============ Intervals =============\n");
+    
+    // 4..11 January 2027 is Monday to Monday, so workdays must give exactly Monday..Friday
+    time_zone_t warsaw = D_ZONE_CENTRAL_EUROPE;
+    interval_set_t workdays;
+    interval_set_init(&workdays);
+    interval_set_add_weekly(&workdays, make_date(2027, 1, 4, 0, 0, 0, 0, 60),
+        make_date(2027, 1, 11, 0, 0, 0, 0, 60), &warsaw, D_WORKDAYS, 9 * 60, 17 * 60);
+    assert(workdays.count == 5);
+    for (size_t i = 0; i < workdays.count; i++)
+    {
+        date_t start = usec_since_zero_to_date(workdays.items[i].start, 60);
+        assert(_weekday_of(start.year, start.month, start.day) == i);
+        printf(" - %s %02d.%02d %02d:%02d\n", D_WEEKDAY_NAMES[_weekday_of(start.year, start.month, start.day)],
+            start.day, start.month, start.hour, start.minute);
+    }
+    
+    // Across the 2028/2029 year boundary: 2029-01-01 is Monday, 2029-01-06 is Saturday
+    interval_set_clear(&workdays);
+    interval_set_add_weekly(&workdays, make_date(2028, 12, 25, 0, 0, 0, 0, 60),
+        make_date(2029, 1, 8, 0, 0, 0, 0, 60), &warsaw, D_WORKDAYS, 9 * 60, 17 * 60);
+    assert(workdays.count == 10);
+    assert(interval_set_contains(&workdays, date_to_usec_since_zero(make_date(2029, 1, 1, 10, 0, 0, 0, 60))));
+    assert(!interval_set_contains(&workdays, date_to_usec_since_zero(make_date(2029, 1, 6, 10, 0, 0, 0, 60))));
+    interval_t new_year = make_interval(make_date(2028, 12, 31, 0, 0, 0, 0, 0), make_date(2029, 1, 2, 0, 0, 0, 0, 0));
+    assert(new_year.end - new_year.start == 48 * 3600000000LL);
+    printf(" - %zu workdays between 2028-12-25 and 2029-01-08\n", workdays.count);
+    
+    // In summer, 09:00 in Warsaw is 07:00 UTC
+    interval_set_clear(&workdays);
+    interval_set_add_weekly(&workdays, make_date(2027, 7, 5, 0, 0, 0, 0, 120),
+        make_date(2027, 7, 6, 0, 0, 0, 0, 120), &warsaw, D_WORKDAYS, 9 * 60, 17 * 60);
+    assert(workdays.count == 1 && workdays.items[0].start == date_to_usec_since_zero(make_date(2027, 7, 5, 7, 0, 0, 0, 0)));
+    interval_set_free(&workdays);
+    
     timediff_t diff = difference(pearl_harbor, now);
     printf("\nAttack on Pearl Harbor happened %d weeks, %d days, %d hrs and %d mins ago.\n",
         diff.weeks, diff.days, diff.hours, diff.minutes);